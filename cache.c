@@ -0,0 +1,560 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Files
+* and Exploration: Processes and I/O.
+*/
+
+#include "cache.h"
+#include "parser.h"
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define CACHE_MAGIC "SMSHSC\r\n"        // 8 bytes, catches text-mode mangling
+#define CACHE_VERSION 2
+#define CACHE_NO_STRING UINT32_MAX      // Marks a missing file name or error
+
+// On-disk layout: header, records, argument table, string table.
+// Every field is fixed width so the file can be used in place once mapped.
+struct cache_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t command_count;     // Entries in the record table
+    uint64_t source_size;       // Key: size of the script when compiled
+    int64_t source_mtime_sec;   // Key: modification time of the script
+    int64_t source_mtime_nsec;
+    uint64_t source_hash;       // Key: hash of the script contents
+    uint32_t arg_count;         // Entries in the argument table
+    uint32_t strings_size;      // Bytes in the string table
+};
+
+struct cache_record {
+    uint32_t first_arg;         // Index of argv[0] in the argument table
+    uint32_t argc;              // Argument count
+    uint32_t input_file;        // String table offset or CACHE_NO_STRING
+    uint32_t output_file;       // String table offset or CACHE_NO_STRING
+    uint32_t is_bg;             // Background process flag
+    uint32_t error;             // Syntax error message or CACHE_NO_STRING
+};
+
+struct script_cache {
+    void *base;                 // Start of the compiled image
+    size_t size;                // Size of the compiled image
+    bool mapped;                // True if base came from mmap, false if malloc
+    const struct cache_header *header;
+    const struct cache_record *records;
+    const uint32_t *args;
+    const char *strings;
+};
+
+// Growable byte buffer used while compiling a script
+struct buffer {
+    char *data;
+    size_t len;
+    size_t cap;
+};
+
+/*
+* Function: buffer_append
+* ----------------------------------
+* Appends bytes to a growable buffer, doubling its capacity as needed.
+* 
+* Arguments: buf - The buffer to append to
+*            data - The bytes to append
+*            len - The number of bytes to append
+* 
+* Returns: void
+*/
+
+static void buffer_append(struct buffer *buf, const void *data, size_t len) {
+    if (buf->len + len > buf->cap) {
+        size_t cap = buf->cap ? buf->cap : 256;
+        while (buf->len + len > cap) cap *= 2;
+        buf->data = realloc(buf->data, cap);
+        if (!buf->data) {
+            perror("realloc");
+            exit(1);
+        }
+        buf->cap = cap;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+/*
+* Function: buffer_append_string
+* ----------------------------------
+* Appends a NUL-terminated string to the string table.
+* 
+* Arguments: strings - The string table being built
+*            str - The string to store, or NULL
+* 
+* Returns: The offset of the string in the table, or CACHE_NO_STRING if str is NULL.
+*/
+
+static uint32_t buffer_append_string(struct buffer *strings, const char *str) {
+    if (!str) return CACHE_NO_STRING;
+    uint32_t offset = strings->len;
+    buffer_append(strings, str, strlen(str) + 1);
+    return offset;
+}
+
+/*
+* Function: hash_update
+* ----------------------------------
+* Feeds a block of memory into a 64-bit FNV-1a hash. Start from
+* HASH_SEED; blocks may be fed in pieces.
+* 
+* Arguments: hash - The hash so far
+*            data - The bytes to hash
+*            len - The number of bytes
+* 
+* Returns: The updated hash value.
+*/
+
+uint64_t hash_update(uint64_t hash, const void *data, size_t len) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+* Function: make_dirs
+* ----------------------------------
+* Creates a directory and any missing parents, like mkdir -p.
+* 
+* Arguments: dir - The directory path. It is modified temporarily.
+* 
+* Returns: 0 on success, -1 on failure.
+*/
+
+static int make_dirs(char *dir) {
+    for (char *p = dir + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        int result = mkdir(dir, 0700);
+        *p = '/';
+        if (result == -1 && errno != EEXIST) return -1;
+    }
+    if (mkdir(dir, 0700) == -1 && errno != EEXIST) return -1;
+    return 0;
+}
+
+/*
+* Function: cache_dir
+* ----------------------------------
+* Finds the shell's cache directory, $SMALLSH_CACHE_DIR,
+* $XDG_CACHE_HOME/smallsh or ~/.cache/smallsh, and creates it
+* (with an optional subdirectory) if needed.
+* 
+* Arguments: dir - Where to store the path
+*            size - The size of dir
+*            sub - A subdirectory such as "memo", or NULL
+* 
+* Returns: True if the directory exists, otherwise False.
+*/
+
+bool cache_dir(char *dir, size_t size, const char *sub) {
+    const char *env;
+    int len;
+    if ((env = getenv("SMALLSH_CACHE_DIR")) && *env) {
+        len = snprintf(dir, size, "%s", env);
+    } else if ((env = getenv("XDG_CACHE_HOME")) && *env) {
+        len = snprintf(dir, size, "%s/smallsh", env);
+    } else if ((env = getenv("HOME")) && *env) {
+        len = snprintf(dir, size, "%s/.cache/smallsh", env);
+    } else {
+        return false;
+    }
+    if (sub && len >= 0 && (size_t)len < size) len += snprintf(dir + len, size - len, "/%s", sub);
+    if (len < 0 || (size_t)len >= size) return false;
+    return make_dirs(dir) == 0;
+}
+
+/*
+* Function: cache_path_for
+* ----------------------------------
+* Builds the cache file name for a script. The file lives in the
+* cache directory and is named after a hash of the script's absolute path.
+* 
+* Arguments: path - The script path
+* 
+* Returns: A dynamically allocated path, or NULL if no cache directory is usable.
+*/
+
+static char *cache_path_for(const char *path) {
+    char dir[PATH_MAX];
+    if (!cache_dir(dir, sizeof(dir), NULL)) return NULL;
+
+    char *full_path = realpath(path, NULL);
+    if (!full_path) return NULL;
+    uint64_t key = hash_update(HASH_SEED, full_path, strlen(full_path));
+    free(full_path);
+
+    size_t size = strlen(dir) + sizeof("/0123456789abcdef.smc");
+    char *cache_path = malloc(size);
+    snprintf(cache_path, size, "%s/%016llx.smc", dir, (unsigned long long)key);
+    return cache_path;
+}
+
+/*
+* Function: cache_attach
+* ----------------------------------
+* Validates a compiled image and points the section pointers into it.
+* Every offset is bounds checked so a truncated or corrupt cache file
+* is rejected instead of being trusted.
+* 
+* Arguments: cache - The cache handle to fill in
+*            base - Start of the compiled image
+*            size - Size of the compiled image
+* 
+* Returns: True if the image is well formed, otherwise False.
+*/
+
+static bool cache_attach(struct script_cache *cache, void *base, size_t size) {
+    const struct cache_header *header = base;
+    if (size < sizeof(*header)) return false;
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != CACHE_VERSION) return false;
+
+    size_t expected = sizeof(*header)
+                    + (size_t)header->command_count * sizeof(struct cache_record)
+                    + (size_t)header->arg_count * sizeof(uint32_t)
+                    + header->strings_size;
+    if (expected != size) return false;
+
+    cache->base = base;
+    cache->size = size;
+    cache->header = header;
+    cache->records = (const struct cache_record *)(header + 1);
+    cache->args = (const uint32_t *)(cache->records + header->command_count);
+    cache->strings = (const char *)(cache->args + header->arg_count);
+
+    // The table always ends in NUL, so every in-range offset is a valid string
+    if (header->strings_size == 0 || cache->strings[header->strings_size - 1] != '\0') return false;
+
+    for (uint32_t i = 0; i < header->arg_count; i++) {
+        if (cache->args[i] >= header->strings_size) return false;
+    }
+    for (uint32_t i = 0; i < header->command_count; i++) {
+        const struct cache_record *rec = &cache->records[i];
+        if (rec->argc > MAX_ARGS) return false;
+        if ((uint64_t)rec->first_arg + rec->argc > header->arg_count) return false;
+        if (rec->input_file != CACHE_NO_STRING && rec->input_file >= header->strings_size) return false;
+        if (rec->output_file != CACHE_NO_STRING && rec->output_file >= header->strings_size) return false;
+        if (rec->error != CACHE_NO_STRING && rec->error >= header->strings_size) return false;
+    }
+    return true;
+}
+
+/*
+* Function: cache_compile
+* ----------------------------------
+* Parses every line of a script and lays the results out in the
+* compiled format. Lines are split exactly as fgets would split
+* them at the prompt, so a compiled script runs the same commands.
+* 
+* Arguments: cache - The cache handle to fill in
+*            source - The script contents
+*            size - The script size in bytes
+*            st - The script's file status, recorded as part of the key
+*            hash - The hash of the script contents
+* 
+* Returns: void
+*/
+
+static void cache_compile(struct script_cache *cache, const char *source, size_t size,
+                          const struct stat *st, uint64_t hash) {
+    struct buffer records = {0}, args = {0}, strings = {0};
+    uint32_t command_count = 0;
+
+    // Offset 0 holds an empty string so the table is never empty
+    buffer_append(&strings, "", 1);
+
+    size_t pos = 0;
+    while (pos < size) {
+        char input[INPUT_LENGTH];
+        size_t len = 0;
+        while (pos < size && len < INPUT_LENGTH - 1) {
+            char c = source[pos++];
+            input[len++] = c;
+            if (c == '\n') break;
+        }
+        input[len] = '\0';
+
+        const char *error;
+        struct command_line *cmd = parse_command(input, &error);
+
+        // Syntax errors are kept so they are reported in order on every run
+        if (error) {
+            struct cache_record rec = {0};
+            rec.first_arg = args.len / sizeof(uint32_t);
+            rec.input_file = rec.output_file = CACHE_NO_STRING;
+            rec.error = buffer_append_string(&strings, error);
+            buffer_append(&records, &rec, sizeof(rec));
+            command_count++;
+            continue;
+        }
+        if (!cmd) continue;  // Ignore blank/comment lines
+
+        struct cache_record rec = {0};
+        rec.first_arg = args.len / sizeof(uint32_t);
+        rec.argc = cmd->argc;
+        for (int i = 0; i < cmd->argc; i++) {
+            uint32_t offset = buffer_append_string(&strings, cmd->argv[i]);
+            buffer_append(&args, &offset, sizeof(offset));
+        }
+        rec.input_file = buffer_append_string(&strings, cmd->input_file);
+        rec.output_file = buffer_append_string(&strings, cmd->output_file);
+        rec.is_bg = cmd->is_bg;
+        rec.error = CACHE_NO_STRING;
+        buffer_append(&records, &rec, sizeof(rec));
+        command_count++;
+        free_command(cmd);
+    }
+
+    struct cache_header header = {0};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.command_count = command_count;
+    header.source_size = st->st_size;
+    header.source_mtime_sec = st->st_mtim.tv_sec;
+    header.source_mtime_nsec = st->st_mtim.tv_nsec;
+    header.source_hash = hash;
+    header.arg_count = args.len / sizeof(uint32_t);
+    header.strings_size = strings.len;
+
+    struct buffer image = {0};
+    buffer_append(&image, &header, sizeof(header));
+    buffer_append(&image, records.data, records.len);
+    buffer_append(&image, args.data, args.len);
+    buffer_append(&image, strings.data, strings.len);
+    free(records.data);
+    free(args.data);
+    free(strings.data);
+
+    cache_attach(cache, image.data, image.len);
+    cache->mapped = false;
+}
+
+/*
+* Function: cache_store
+* ----------------------------------
+* Writes a compiled image to disk. The image goes to a temporary
+* file first and is renamed into place, so readers never see a
+* partially written cache. Failures are ignored; the cache is only
+* an optimization.
+* 
+* Arguments: cache_path - Where the cache file belongs
+*            cache - The compiled image to write
+* 
+* Returns: void
+*/
+
+static void cache_store(const char *cache_path, const struct script_cache *cache) {
+    char tmp_path[PATH_MAX];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", cache_path);
+    int fd = mkstemp(tmp_path);
+    if (fd == -1) return;
+
+    const char *data = cache->base;
+    size_t remaining = cache->size;
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            close(fd);
+            unlink(tmp_path);
+            return;
+        }
+        data += written;
+        remaining -= written;
+    }
+    close(fd);
+    if (rename(tmp_path, cache_path) == -1) unlink(tmp_path);
+}
+
+/*
+* Function: cache_load
+* ----------------------------------
+* Maps a cache file and checks that it was compiled from the
+* script as it is now: same size, modification time and contents.
+* 
+* Arguments: cache - The cache handle to fill in
+*            cache_path - The cache file to map
+*            st - The script's current file status
+*            hash - The hash of the script's current contents
+* 
+* Returns: True if the cache is usable, otherwise False.
+*/
+
+static bool cache_load(struct script_cache *cache, const char *cache_path,
+                       const struct stat *st, uint64_t hash) {
+    int fd = open(cache_path, O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat cache_st;
+    if (fstat(fd, &cache_st) == -1 || cache_st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(NULL, cache_st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    if (cache_attach(cache, base, cache_st.st_size)
+        && cache->header->source_size == (uint64_t)st->st_size
+        && cache->header->source_mtime_sec == st->st_mtim.tv_sec
+        && cache->header->source_mtime_nsec == st->st_mtim.tv_nsec
+        && cache->header->source_hash == hash) {
+        cache->mapped = true;
+        return true;
+    }
+    munmap(base, cache_st.st_size);
+    return false;
+}
+
+/*
+* Function: script_cache_open
+* ----------------------------------
+* Returns the compiled form of a script. If an up-to-date cache file
+* exists it is mapped and used in place, skipping parsing entirely.
+* Otherwise the script is parsed, and the result is saved for next time.
+* 
+* Arguments: path - The script to open
+* 
+* Returns: A cache handle, or NULL with errno set if the script cannot be read.
+*/
+
+struct script_cache *script_cache_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return NULL;
+    }
+
+    // Map the script so it can be hashed (and compiled) without copying
+    const char *source = "";
+    if (st.st_size > 0) {
+        source = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (source == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+    }
+    close(fd);
+    uint64_t hash = hash_update(HASH_SEED, source, st.st_size);
+
+    struct script_cache *cache = calloc(1, sizeof(struct script_cache));
+    char *cache_path = cache_path_for(path);
+    if (!cache_path || !cache_load(cache, cache_path, &st, hash)) {
+        cache_compile(cache, source, st.st_size, &st, hash);
+        if (cache_path) cache_store(cache_path, cache);
+    }
+    free(cache_path);
+    if (st.st_size > 0) munmap((void *)source, st.st_size);
+    return cache;
+}
+
+/*
+* Function: script_cache_count
+* ----------------------------------
+* Returns the number of commands in a compiled script.
+* 
+* Arguments: cache - The compiled script
+* 
+* Returns: The command count.
+*/
+
+int script_cache_count(const struct script_cache *cache) {
+    return cache->header->command_count;
+}
+
+/*
+* Function: script_cache_command
+* ----------------------------------
+* Fills in a command_line struct for one command of a compiled script.
+* The strings are not copied: they point into the compiled image, so
+* the struct must not be passed to free_command and is only valid
+* until script_cache_close.
+* 
+* Arguments: cache - The compiled script
+*            index - Which command to load
+*            cmd - The struct to fill in
+* 
+* Returns: void
+*/
+
+void script_cache_command(const struct script_cache *cache, int index, struct command_line *cmd) {
+    const struct cache_record *rec = &cache->records[index];
+
+    cmd->argc = rec->argc;
+    for (uint32_t i = 0; i < rec->argc; i++) {
+        cmd->argv[i] = (char *)cache->strings + cache->args[rec->first_arg + i];
+    }
+    cmd->argv[cmd->argc] = NULL;
+    cmd->input_file = rec->input_file == CACHE_NO_STRING ? NULL : (char *)cache->strings + rec->input_file;
+    cmd->output_file = rec->output_file == CACHE_NO_STRING ? NULL : (char *)cache->strings + rec->output_file;
+    cmd->is_bg = rec->is_bg;
+}
+
+/*
+* Function: script_cache_error
+* ----------------------------------
+* Checks whether a line of a compiled script had a syntax error.
+* Such lines have no command to run; the error is reported instead.
+* 
+* Arguments: cache - The compiled script
+*            index - Which command to check
+* 
+* Returns: The error message, or NULL if the command is valid.
+*/
+
+const char *script_cache_error(const struct script_cache *cache, int index) {
+    uint32_t error = cache->records[index].error;
+    return error == CACHE_NO_STRING ? NULL : cache->strings + error;
+}
+
+/*
+* Function: script_cache_close
+* ----------------------------------
+* Releases a compiled script.
+* 
+* Arguments: cache - The compiled script
+* 
+* Returns: void
+*/
+
+void script_cache_close(struct script_cache *cache) {
+    if (cache->mapped) {
+        munmap(cache->base, cache->size);
+    } else {
+        free(cache->base);
+    }
+    free(cache);
+}
@@ -0,0 +1,39 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "smallsh.h"
+#include <stdint.h>
+
+#define HASH_SEED 14695981039346656037ULL   // FNV-1a offset basis
+
+// A compiled script, either mapped from the on-disk cache or freshly built
+struct script_cache;
+
+struct script_cache *script_cache_open(const char *path);
+int script_cache_count(const struct script_cache *cache);
+void script_cache_command(const struct script_cache *cache, int index, struct command_line *cmd);
+const char *script_cache_error(const struct script_cache *cache, int index);
+void script_cache_close(struct script_cache *cache);
+
+uint64_t hash_update(uint64_t hash, const void *data, size_t len);
+bool cache_dir(char *dir, size_t size, const char *sub);
+
+#endif
@@ -25,20 +25,49 @@
 */
 
 #include "commands.h"
+#include "jobs.h"
+#include "watch.h"
+#include "memo.h"
+#include "status.h"
+
+/*
+* Function: is_builtin_command
+* ----------------------------------
+* Checks whether a command would be handled by builtin_commands,
+* without running it.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: True if the command is a built-in command, otherwise returns False.
+*/
+
+bool is_builtin_command(struct command_line *cmd) {
+    if (cmd->argc == 0) return false;
+    return strcmp(cmd->argv[0], "exit") == 0
+        || strcmp(cmd->argv[0], "cd") == 0
+        || strcmp(cmd->argv[0], "status") == 0
+        || strcmp(cmd->argv[0], "wait") == 0
+        || strcmp(cmd->argv[0], "jobs") == 0
+        || strcmp(cmd->argv[0], "bgsched") == 0
+        || strcmp(cmd->argv[0], "prio") == 0
+        || strcmp(cmd->argv[0], "joblog") == 0
+        || strcmp(cmd->argv[0], "on-change") == 0
+        || strcmp(cmd->argv[0], "memo") == 0;
+}
 
 /*
 * Function: builtin_commands
 * ----------------------------------
-* Handles built-in commands like exit, cd, and status.
+* Handles built-in commands like exit, cd, status, wait, jobs,
+* bgsched, joblog, on-change, memo, and the prio prefix ("prio N command &" queues a background
+* command with priority N).
 * 
 * Arguments: cmd - The parsed command structure
-*            bg_pids - An array of background process IDs
-*            bg_count - The number of background processes
 * 
 * Returns: True if a built-in command was handled, otherwise returns False.
 */
 
-bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count) {
+bool builtin_commands(struct command_line *cmd) {
     if (cmd->argc == 0) return false;
 
     // Map command strings to integer values
@@ -46,12 +75,17 @@ bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count) {
     if (strcmp(cmd->argv[0], "exit") == 0) command_type = 0;
     else if (strcmp(cmd->argv[0], "cd") == 0) command_type = 1;
     else if (strcmp(cmd->argv[0], "status") == 0) command_type = 2;
+    else if (strcmp(cmd->argv[0], "wait") == 0) command_type = 3;
+    else if (strcmp(cmd->argv[0], "jobs") == 0) command_type = 4;
+    else if (strcmp(cmd->argv[0], "bgsched") == 0) command_type = 5;
+    else if (strcmp(cmd->argv[0], "prio") == 0) command_type = 6;
+    else if (strcmp(cmd->argv[0], "joblog") == 0) command_type = 7;
+    else if (strcmp(cmd->argv[0], "on-change") == 0) command_type = 8;
+    else if (strcmp(cmd->argv[0], "memo") == 0) command_type = 9;
 
     switch (command_type) {
         case 0: // "exit"
-            for (int i = 0; i < *bg_count; i++) {
-                kill(bg_pids[i], SIGTERM);  // Terminate all bg processes
-            }
+            jobs_kill_all();    // Terminate all bg processes
             exit(0);
             break;
 
@@ -74,6 +108,49 @@ bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count) {
             fflush(stdout);
             return true;
 
+        case 3: // "wait"
+            // Block until every bg process has finished
+            jobs_wait_all();
+            return true;
+
+        case 4: // "jobs"
+            jobs_print();
+            return true;
+
+        case 5: // "bgsched"
+            jobs_sched_command(cmd);
+            return true;
+
+        case 6: { // "prio"
+            if (cmd->argc < 3) {
+                fprintf(stderr, "usage: prio N command [args] &\n");
+                return true;
+            }
+            // Run the rest of the line as its own command
+            struct command_line sub = *cmd;
+            sub.argc = cmd->argc - 2;
+            memmove(sub.argv, cmd->argv + 2, (sub.argc + 1) * sizeof(char *));
+            if (sub.is_bg && !foreground_only_mode) {
+                jobs_submit(&sub, atoi(cmd->argv[1]));
+            } else {
+                execute_other_commands(&sub);
+            }
+            return true;
+        }
+
+        case 7: // "joblog"
+            jobs_log_command(cmd);
+            return true;
+
+        case 8: // "on-change"
+            // Runs in the fg until Ctrl+C
+            watch_command(cmd);
+            return true;
+
+        case 9: // "memo"
+            memo_command(cmd);
+            return true;
+
         default:
             return false;   // Not a built-in command
     }
@@ -81,71 +158,88 @@ bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count) {
     return true;    // Command was handled
 }
 
+/*
+* Function: run_child
+* ----------------------------------
+* Runs in a newly forked child: sets up signal handling and
+* input/output redirection, then replaces the process image with
+* the command. Never returns.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: void
+*/
+
+void run_child(struct command_line *cmd) {
+    struct sigaction sa_ignore = {0};
+    sa_ignore.sa_handler = SIG_IGN;
+    sigaction(SIGTSTP, &sa_ignore, NULL);   // Ignore SIGTSTP in child process
+
+    // Handle input redirection
+    if (cmd->input_file) {
+        int input_fd = open(cmd->input_file, O_RDONLY);
+        if (input_fd == -1) {
+            fprintf(stderr, "cannot open %s for input\n", cmd->input_file);
+            exit(1);
+        }
+        dup2(input_fd, 0);
+        close(input_fd);
+    }
+
+    // Handle output redirection
+    if (cmd->output_file) {
+        int output_fd = open(cmd->output_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output_fd == -1) {
+            fprintf(stderr, "cannot open %s for output\n", cmd->output_file);
+            exit(1);
+        }
+        dup2(output_fd, 1); // Redirect stdout
+        close(output_fd);
+    }
+
+    // Execute the command
+    execvp(cmd->argv[0], cmd->argv);
+
+    // If execvp fails, print an error message and exit
+    perror(cmd->argv[0]);
+    exit(1);
+}
+
 /*
 * Function: execute_other_commands
 * ----------------------------------
 * Executes external commands using fork() and execvp().
-* Handles input/output redirection and background execution.
+* Handles input/output redirection. Background commands are handed
+* to the job scheduler.
 * 
 * Arguments: cmd - The parsed command structure
-*            bg_pids - An array of background process IDs
-*            bg_count - The number of background processes
 * 
 * Returns: void
 */
 
-void execute_other_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count) {
+void execute_other_commands(struct command_line *cmd) {
     // If fg-only mode is active, force the process to run in the fg
     if (foreground_only_mode) cmd->is_bg = false;
 
+    // Background commands may be queued, so the scheduler forks them
+    if (cmd->is_bg) {
+        jobs_submit(cmd, 0);
+        return;
+    }
+
     pid_t spawn_pid = fork();
     if (spawn_pid == -1) {
         perror("fork failed");
         exit(1);
     } else if (spawn_pid == 0) {    // Child process
-        struct sigaction sa_ignore = {0};
-        sa_ignore.sa_handler = SIG_IGN;
-        sigaction(SIGTSTP, &sa_ignore, NULL);   // Ignore SIGTSTP in child process
-
-        // Handle input redirection
-        if (cmd->input_file) {
-            int input_fd = open(cmd->input_file, O_RDONLY);
-            if (input_fd == -1) {
-                fprintf(stderr, "cannot open %s for input\n", cmd->input_file);
-                exit(1);
-            }
-            dup2(input_fd, 0);
-            close(input_fd);
-        }
-
-        // Handle output redirection
-        if (cmd->output_file) {
-            int output_fd = open(cmd->output_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-            if (output_fd == -1) {
-                fprintf(stderr, "cannot open %s for output\n", cmd->output_file);
-                exit(1);
-            }
-            dup2(output_fd, 1); // Redirect stdout
-            close(output_fd);
-        }
-
-        // Execute the command
-        execvp(cmd->argv[0], cmd->argv);
-
-        // If execvp fails, print an error message and exit
-        perror(cmd->argv[0]);
-        exit(1);
+        run_child(cmd);
     } else {    // Parent process
-        if (cmd->is_bg) {
-            // If bg process, store the PID and print message
-            printf("background pid is %d\n", spawn_pid);
-            fflush(stdout);
-            bg_pids[(*bg_count)++] = spawn_pid;
-        } else {
-            // If foreground process, wait for it to finish
-            int child_status;
-            waitpid(spawn_pid, &child_status, 0);
-            last_exit_status = child_status;    // Store exit status
-        }
+        status_set_foreground(spawn_pid, cmd);
+
+        // Wait for the fg process to finish; bg jobs are serviced meanwhile
+        int child_status;
+        while (jobs_wait(-1, -1, &child_status) != spawn_pid);
+        last_exit_status = child_status;    // Store exit status
+        status_set_foreground(0, NULL);
     }
 }
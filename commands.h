@@ -21,7 +21,9 @@
 
 #include "smallsh.h"
 
-bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count);
-void execute_other_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count);
+bool is_builtin_command(struct command_line *cmd);
+bool builtin_commands(struct command_line *cmd);
+void execute_other_commands(struct command_line *cmd);
+void run_child(struct command_line *cmd);
 
 #endif
@@ -0,0 +1,816 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Process
+* API - Monitoring Child Processes and Exploration: Signal Handling API.
+*/
+
+/*
+* Background job scheduler
+* ----------------------------------
+* Every & command becomes a job. A job starts right away only if fewer
+* than max_running jobs are running and the system is not under
+* pressure; otherwise it waits in a priority queue. Pressure is read
+* from /proc/pressure/{cpu,memory} (the "some avg10" figure), or from
+* the 1-minute load average per CPU where PSI is not available. A job
+* is always admitted when nothing else is running, so the queue cannot
+* stall behind load from outside the shell.
+* 
+* Children are reaped in jobs_wait, which also waits for foreground
+* commands. SIGCHLD wakes it through a self-pipe, so queued jobs are
+* released as soon as running ones finish, even at the prompt.
+* 
+* In capture mode (joblog capture on), a job's terminal stdout and its
+* stderr go through a pipe that jobs_wait drains into a per-job ring
+* buffer holding the last few KB. joblog PID prints the buffer, and
+* finished jobs keep theirs for a while after "is done" is printed.
+*/
+
+#include "jobs.h"
+#include "commands.h"
+#include "parser.h"
+#include "signals.h"
+#include "status.h"
+#include <errno.h>
+#include <poll.h>
+
+#define PRESSURE_RECHECK_MS 1000    // How often held jobs recheck pressure
+
+static struct job jobs[MAX_JOBS];   // Queued, running and unreported jobs
+static int job_count = 0;
+static int running_count = 0;
+static int next_job_id = 1;
+
+// Scheduler settings, changed with the bgsched built-in
+static int max_running;             // Running job limit
+static double cpu_pressure_limit;   // Hold jobs at or above this PSI cpu avg10, 0 = off
+static double memory_pressure_limit;// Hold jobs at or above this PSI memory avg10, 0 = off
+static double load_limit;           // Hold jobs at or above this load per CPU, 0 = off
+
+// Output capture settings, changed with the joblog built-in
+static bool capture_output;         // Send bg output to ring buffers instead of the terminal
+static size_t log_size;             // Ring buffer size for new jobs, in bytes
+static int log_keep;                // Seconds to keep a finished job's buffer
+
+/*
+* Function: open_self_pipe
+* ----------------------------------
+* Creates a non-blocking pipe that a signal handler writes to, so the
+* wait loop's poll wakes up even if the signal lands just before it.
+* 
+* Arguments: fds - Where to store the pipe's descriptors
+* 
+* Returns: void
+*/
+
+static void open_self_pipe(int fds[2]) {
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        exit(1);
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+}
+
+/*
+* Function: jobs_init
+* ----------------------------------
+* Sets the scheduler defaults and creates the SIGCHLD self-pipe.
+* Must be called before the SIGCHLD handler is installed.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_init(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    max_running = cpus > 0 ? cpus : 1;
+    cpu_pressure_limit = 60.0;
+    memory_pressure_limit = 20.0;
+    load_limit = 2.0;
+    capture_output = false;
+    log_size = 64 * 1024;
+    log_keep = 300;
+
+    open_self_pipe(sigchld_pipe);
+    open_self_pipe(sigint_pipe);
+}
+
+/*
+* Function: command_text
+* ----------------------------------
+* Rebuilds a command line for display.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: A dynamically allocated string.
+*/
+
+static char *command_text(const struct command_line *cmd) {
+    size_t size = 1;
+    for (int i = 0; i < cmd->argc; i++) size += strlen(cmd->argv[i]) + 1;
+    if (cmd->input_file) size += strlen(cmd->input_file) + 3;
+    if (cmd->output_file) size += strlen(cmd->output_file) + 3;
+
+    char *text = calloc(1, size);
+    for (int i = 0; i < cmd->argc; i++) {
+        if (i > 0) strcat(text, " ");
+        strcat(text, cmd->argv[i]);
+    }
+    if (cmd->input_file) {
+        strcat(text, " < ");
+        strcat(text, cmd->input_file);
+    }
+    if (cmd->output_file) {
+        strcat(text, " > ");
+        strcat(text, cmd->output_file);
+    }
+    return text;
+}
+
+/*
+* Function: read_pressure
+* ----------------------------------
+* Reads the "some avg10" value from a PSI file such as /proc/pressure/cpu.
+* 
+* Arguments: path - The PSI file
+*            value - Where to store the percentage
+* 
+* Returns: True if the value was read, otherwise False.
+*/
+
+static bool read_pressure(const char *path, double *value) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+    bool found = fscanf(file, "some avg10=%lf", value) == 1;
+    fclose(file);
+    return found;
+}
+
+/*
+* Function: system_under_pressure
+* ----------------------------------
+* Checks whether CPU or memory pressure is above the configured limits.
+* 
+* Arguments: None.
+* 
+* Returns: True if new jobs should be held, otherwise False.
+*/
+
+static bool system_under_pressure(void) {
+    double value;
+    bool have_psi = false;
+
+    if (read_pressure("/proc/pressure/cpu", &value)) {
+        have_psi = true;
+        if (cpu_pressure_limit > 0 && value >= cpu_pressure_limit) return true;
+    }
+    if (read_pressure("/proc/pressure/memory", &value)) {
+        have_psi = true;
+        if (memory_pressure_limit > 0 && value >= memory_pressure_limit) return true;
+    }
+
+    // Fall back to the load average on kernels without PSI
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!have_psi && load_limit > 0 && getloadavg(&value, 1) == 1) {
+        if (value / (cpus > 0 ? cpus : 1) >= load_limit) return true;
+    }
+    return false;
+}
+
+/*
+* Function: start_job
+* ----------------------------------
+* Forks a queued job.
+* 
+* Arguments: job - The job to start
+* 
+* Returns: void
+*/
+
+static void start_job(struct job *job) {
+    int capture[2] = {-1, -1};
+    char *log = NULL;
+    if (job->log_size) {
+        // Without a ring buffer or a pipe the job runs uncaptured
+        log = malloc(job->log_size);
+        if (!log) perror("joblog");
+        else if (pipe(capture) == -1) {
+            perror("pipe");
+            free(log);
+            log = NULL;
+        }
+        if (!log) job->log_size = 0;
+    }
+
+    fflush(stdout);
+    pid_t spawn_pid = fork();
+    if (spawn_pid == -1) {
+        perror("fork failed");
+        exit(1);
+    } else if (spawn_pid == 0) {    // Child process
+        if (capture[1] != -1) {
+            if (!job->cmd->output_file) dup2(capture[1], 1);
+            dup2(capture[1], 2);
+            close(capture[0]);
+            close(capture[1]);
+        }
+        run_child(job->cmd);
+    }
+
+    job->pid = spawn_pid;
+    job->state = JOB_RUNNING;
+    job->start_time = time(NULL);
+    free_command(job->cmd);
+    job->cmd = NULL;
+    running_count++;
+
+    if (capture[1] != -1) {
+        close(capture[1]);
+        fcntl(capture[0], F_SETFL, O_NONBLOCK);
+        fcntl(capture[0], F_SETFD, FD_CLOEXEC);
+        job->capture_fd = capture[0];
+        job->log = log;
+    }
+    status_update();
+}
+
+/*
+* Function: log_append
+* ----------------------------------
+* Appends output to a job's ring buffer, overwriting the oldest bytes
+* once it is full.
+* 
+* Arguments: job - The job
+*            data - The output
+*            len - The number of bytes
+* 
+* Returns: void
+*/
+
+static void log_append(struct job *job, const char *data, size_t len) {
+    if (len > job->log_size) {
+        data += len - job->log_size;
+        len = job->log_size;
+    }
+    size_t end = (job->log_start + job->log_len) % job->log_size;
+    size_t first = job->log_size - end < len ? job->log_size - end : len;
+    memcpy(job->log + end, data, first);
+    memcpy(job->log, data + first, len - first);
+
+    job->log_len += len;
+    if (job->log_len > job->log_size) {
+        job->log_start = (job->log_start + job->log_len - job->log_size) % job->log_size;
+        job->log_len = job->log_size;
+    }
+}
+
+/*
+* Function: drain_capture
+* ----------------------------------
+* Moves everything currently in a job's output pipe into its ring
+* buffer, closing the pipe once the job's side has closed it.
+* 
+* Arguments: job - The job
+* 
+* Returns: void
+*/
+
+static void drain_capture(struct job *job) {
+    char buffer[4096];
+    while (job->capture_fd != -1) {
+        ssize_t n = read(job->capture_fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            log_append(job, buffer, n);
+        } else if (n == -1 && errno == EINTR) {
+            continue;
+        } else {
+            if (n == 0 || errno != EAGAIN) {
+                close(job->capture_fd);
+                job->capture_fd = -1;
+            }
+            return;
+        }
+    }
+}
+
+/*
+* Function: has_queued_jobs
+* ----------------------------------
+* Checks whether any job is waiting to start.
+* 
+* Arguments: None.
+* 
+* Returns: True if a job is queued, otherwise False.
+*/
+
+static bool has_queued_jobs(void) {
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].state == JOB_QUEUED) return true;
+    }
+    return false;
+}
+
+/*
+* Function: has_open_captures
+* ----------------------------------
+* Checks whether any job output pipe still needs draining.
+* 
+* Arguments: None.
+* 
+* Returns: True if a capture pipe is open, otherwise False.
+*/
+
+static bool has_open_captures(void) {
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].capture_fd != -1) return true;
+    }
+    return false;
+}
+
+/*
+* Function: dispatch_jobs
+* ----------------------------------
+* Starts queued jobs, highest priority first and oldest first within
+* a priority, while the running limit and system pressure allow.
+* 
+* Arguments: None.
+* 
+* Returns: True if queued jobs are being held back by pressure.
+*/
+
+static bool dispatch_jobs(void) {
+    while (running_count < max_running) {
+        struct job *best = NULL;
+        for (int i = 0; i < job_count; i++) {
+            if (jobs[i].state == JOB_QUEUED && (!best || jobs[i].priority > best->priority)) {
+                best = &jobs[i];
+            }
+        }
+        if (!best) return false;
+        if (running_count > 0 && system_under_pressure()) return true;
+        start_job(best);
+    }
+    return false;
+}
+
+/*
+* Function: job_exited
+* ----------------------------------
+* Records the exit of a reaped child if it is a running job.
+* 
+* Arguments: pid - The reaped process ID
+*            child_status - The status returned by waitpid
+* 
+* Returns: True if pid was a background job, otherwise returns False.
+*/
+
+static bool job_exited(pid_t pid, int child_status) {
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].state == JOB_RUNNING && jobs[i].pid == pid) {
+            jobs[i].state = JOB_DONE;
+            jobs[i].status = child_status;
+            running_count--;
+            status_update();
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+* Function: remove_job
+* ----------------------------------
+* Removes a job from the table, keeping the others in order.
+* 
+* Arguments: index - The job's position in the table
+* 
+* Returns: void
+*/
+
+static void remove_job(int index) {
+    if (jobs[index].cmd) free_command(jobs[index].cmd);
+    if (jobs[index].capture_fd != -1) close(jobs[index].capture_fd);
+    free(jobs[index].text);
+    free(jobs[index].log);
+    memmove(&jobs[index], &jobs[index + 1], (job_count - index - 1) * sizeof(struct job));
+    job_count--;
+}
+
+/*
+* Function: jobs_submit
+* ----------------------------------
+* Enters a background command into the job table. It starts right
+* away if the scheduler admits it, otherwise it is queued.
+* 
+* Arguments: cmd - The parsed command structure. It is copied.
+*            priority - Queue priority; higher starts first
+* 
+* Returns: void
+*/
+
+void jobs_submit(struct command_line *cmd, int priority) {
+    // Make room by dropping the oldest retained log
+    for (int i = 0; i < job_count && job_count == MAX_JOBS; i++) {
+        if (jobs[i].reported) remove_job(i);
+    }
+    if (job_count == MAX_JOBS) {
+        fprintf(stderr, "too many background jobs\n");
+        return;
+    }
+
+    struct job *job = &jobs[job_count++];
+    memset(job, 0, sizeof(*job));
+    job->id = next_job_id++;
+    job->state = JOB_QUEUED;
+    job->priority = priority;
+    job->submit_time = time(NULL);
+    job->cmd = copy_command(cmd);
+    job->text = command_text(cmd);
+    job->capture_fd = -1;
+    job->log_size = capture_output ? log_size : 0;  // Settings at submission, not at start
+
+    dispatch_jobs();
+    if (job->state == JOB_RUNNING) {
+        printf("background pid is %d\n", job->pid);
+        job->announced = true;
+    } else {
+        printf("background job %d is queued\n", job->id);
+    }
+    fflush(stdout);
+    status_update();
+}
+
+/*
+* Function: jobs_report
+* ----------------------------------
+* Reaps finished jobs and reports queued jobs that have since started
+* and jobs that have finished. Finished jobs are removed from the table.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_report(void) {
+    for (int i = 0; i < job_count; i++) {
+        int child_status;
+        if (jobs[i].state == JOB_RUNNING && waitpid(jobs[i].pid, &child_status, WNOHANG) > 0) {
+            job_exited(jobs[i].pid, child_status);
+        }
+    }
+    dispatch_jobs();
+
+    time_t now = time(NULL);
+    for (int i = 0; i < job_count; i++) {
+        struct job *job = &jobs[i];
+        if (job->state != JOB_QUEUED && !job->announced) {
+            printf("background pid is %d\n", job->pid);
+            job->announced = true;
+        }
+        if (job->state == JOB_DONE && !job->reported) {
+            drain_capture(job);     // Keep the job's final output
+            if (WIFEXITED(job->status)) {
+                printf("background pid %d is done: exit value %d\n", job->pid, WEXITSTATUS(job->status));
+            } else if (WIFSIGNALED(job->status)) {
+                printf("background pid %d is done: terminated by signal %d\n", job->pid, WTERMSIG(job->status));
+            }
+            job->reported = true;
+            job->done_time = now;
+        }
+        // Finished jobs stay listed only while their log is retained
+        if (job->reported && (!job->log || now - job->done_time >= log_keep)) {
+            remove_job(i--);
+        }
+    }
+    fflush(stdout);
+    status_update();
+}
+
+/*
+* Function: now_ms
+* ----------------------------------
+* Reads the monotonic clock.
+* 
+* Arguments: None.
+* 
+* Returns: The current time in milliseconds.
+*/
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+/*
+* Function: jobs_wait
+* ----------------------------------
+* The shell's wait loop. Reaps children and keeps the job queue moving
+* until a child exits, fd becomes readable, the timeout expires or a
+* signal other than SIGCHLD arrives.
+* 
+* Arguments: fd - A descriptor to watch for input, or -1
+*            timeout_ms - How long to wait, or -1 to wait indefinitely
+*            status - Where to store the exited child's status, or NULL
+* 
+* Returns: - The PID of an exited child that is not a background job.
+*          - 0 if fd is readable.
+*          - -1 with errno set to EINTR if a background job finished or a
+*            signal arrived, or ETIMEDOUT if the timeout expired.
+*/
+
+pid_t jobs_wait(int fd, int timeout_ms, int *status) {
+    long long deadline = timeout_ms >= 0 ? now_ms() + timeout_ms : -1;
+
+    while (true) {
+        // Reap everything that has exited so far
+        int child_status;
+        pid_t pid;
+        bool job_finished = false;
+        while ((pid = waitpid(-1, &child_status, WNOHANG)) > 0) {
+            if (job_exited(pid, child_status)) {
+                job_finished = true;
+                continue;
+            }
+            if (status) *status = child_status;
+            return pid;
+        }
+        bool held = dispatch_jobs();
+        if (job_finished) {
+            errno = EINTR;
+            return -1;
+        }
+
+        int wait_ms = -1;
+        if (deadline >= 0) {
+            wait_ms = deadline - now_ms();
+            if (wait_ms < 0) wait_ms = 0;
+        }
+        if (held && (wait_ms < 0 || wait_ms > PRESSURE_RECHECK_MS)) wait_ms = PRESSURE_RECHECK_MS;
+
+        // Watch the self-pipes, the caller's descriptor and every capture pipe
+        struct pollfd fds[MAX_JOBS + 3];
+        struct job *owners[MAX_JOBS + 3];
+        int nfds = 0;
+        fds[nfds++] = (struct pollfd){ .fd = sigchld_pipe[0], .events = POLLIN };
+        fds[nfds++] = (struct pollfd){ .fd = sigint_pipe[0], .events = POLLIN };
+        if (fd >= 0) fds[nfds++] = (struct pollfd){ .fd = fd, .events = POLLIN };
+        int first_capture = nfds;
+        for (int i = 0; i < job_count; i++) {
+            if (jobs[i].capture_fd == -1) continue;
+            owners[nfds] = &jobs[i];
+            fds[nfds++] = (struct pollfd){ .fd = jobs[i].capture_fd, .events = POLLIN };
+        }
+        int ready = poll(fds, nfds, wait_ms);
+
+        // Empty the self-pipe; any byte means SIGCHLD arrived
+        char drain[64];
+        bool got_sigchld = false;
+        while (read(sigchld_pipe[0], drain, sizeof(drain)) > 0) got_sigchld = true;
+        bool got_sigint = false;
+        while (read(sigint_pipe[0], drain, sizeof(drain)) > 0) got_sigint = true;
+
+        if (ready == -1) {
+            if (errno != EINTR) return -1;
+            if (got_sigchld && !got_sigint) continue;
+            return -1;  // Interrupted by another signal
+        }
+        if (got_sigint) {
+            errno = EINTR;
+            return -1;
+        }
+        for (int i = first_capture; i < nfds; i++) {
+            if (fds[i].revents) drain_capture(owners[i]);
+        }
+        if (fd >= 0 && (fds[2].revents & (POLLIN | POLLHUP | POLLERR))) return 0;
+        if (deadline >= 0 && now_ms() >= deadline) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+    }
+}
+
+/*
+* Function: jobs_wait_for_input
+* ----------------------------------
+* Called before the shell blocks reading fd. While jobs are queued or
+* their output is captured, they keep being serviced until fd is
+* readable instead of waiting for the next command.
+* 
+* Arguments: fd - The input descriptor
+* 
+* Returns: void
+*/
+
+void jobs_wait_for_input(int fd) {
+    if (!has_queued_jobs() && !has_open_captures()) return;
+    while (jobs_wait(fd, -1, NULL) != 0);
+}
+
+/*
+* Function: jobs_wait_all
+* ----------------------------------
+* Blocks until every queued and running job has finished, then reports them.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_wait_all(void) {
+    while (running_count > 0 || has_queued_jobs()) {
+        jobs_wait(-1, -1, NULL);
+    }
+    jobs_report();
+}
+
+/*
+* Function: jobs_drain_queue
+* ----------------------------------
+* Blocks until every queued job has been started. Used before the
+* shell exits at end of input, so queued jobs are not lost.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_drain_queue(void) {
+    while (has_queued_jobs()) {
+        jobs_wait(-1, -1, NULL);
+    }
+}
+
+/*
+* Function: jobs_kill_all
+* ----------------------------------
+* Terminates every running job and discards queued ones.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_kill_all(void) {
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].state == JOB_RUNNING) kill(jobs[i].pid, SIGTERM);
+    }
+}
+
+/*
+* Function: jobs_print
+* ----------------------------------
+* Lists every job with its state, as shown by the jobs built-in.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void jobs_print(void) {
+    time_t now = time(NULL);
+    for (int i = 0; i < job_count; i++) {
+        struct job *job = &jobs[i];
+        if (job->state == JOB_QUEUED) {
+            printf("[%d] queued   priority %d, waiting %lds: %s\n", job->id, job->priority,
+                   (long)(now - job->submit_time), job->text);
+        } else if (job->state == JOB_RUNNING) {
+            printf("[%d] running  pid %d, running %lds: %s\n", job->id, job->pid,
+                   (long)(now - job->start_time), job->text);
+        } else {
+            printf("[%d] done     pid %d%s: %s\n", job->id, job->pid,
+                   job->log ? ", log kept" : "", job->text);
+        }
+    }
+    fflush(stdout);
+}
+
+/*
+* Function: jobs_sched_command
+* ----------------------------------
+* Implements the bgsched built-in. With no arguments it prints the
+* scheduler settings; "bgsched max N", "bgsched cpu PCT",
+* "bgsched memory PCT" and "bgsched load N" change them. A limit
+* of 0 turns that pressure check off.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: void
+*/
+
+void jobs_sched_command(struct command_line *cmd) {
+    if (cmd->argc == 1) {
+        int queued_count = 0;
+        for (int i = 0; i < job_count; i++) {
+            if (jobs[i].state == JOB_QUEUED) queued_count++;
+        }
+        printf("max %d, cpu %g, memory %g, load %g; %d running, %d queued\n",
+               max_running, cpu_pressure_limit, memory_pressure_limit, load_limit,
+               running_count, queued_count);
+        fflush(stdout);
+        return;
+    }
+
+    char *end = NULL;
+    double value = cmd->argc == 3 ? strtod(cmd->argv[2], &end) : -1;
+    if (!end || *end != '\0' || value < 0) {
+        fprintf(stderr, "usage: bgsched [max N | cpu PCT | memory PCT | load N]\n");
+    } else if (strcmp(cmd->argv[1], "max") == 0 && value >= 1) {
+        max_running = value;
+    } else if (strcmp(cmd->argv[1], "cpu") == 0) {
+        cpu_pressure_limit = value;
+    } else if (strcmp(cmd->argv[1], "memory") == 0) {
+        memory_pressure_limit = value;
+    } else if (strcmp(cmd->argv[1], "load") == 0) {
+        load_limit = value;
+    } else {
+        fprintf(stderr, "usage: bgsched [max N | cpu PCT | memory PCT | load N]\n");
+    }
+    dispatch_jobs();
+}
+
+/*
+* Function: jobs_log_command
+* ----------------------------------
+* Implements the joblog built-in. "joblog PID" prints the captured
+* output of a running or recently finished job. With no arguments it
+* prints the capture settings; "joblog capture on|off", "joblog size KB"
+* and "joblog keep SECONDS" change them.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: void
+*/
+
+void jobs_log_command(struct command_line *cmd) {
+    const char *usage = "usage: joblog [PID | capture on|off | size KB | keep SECONDS]\n";
+
+    if (cmd->argc == 1) {
+        printf("capture %s, size %zu KB, keep %d s\n", capture_output ? "on" : "off",
+               log_size / 1024, log_keep);
+        fflush(stdout);
+    } else if (cmd->argc == 2) {
+        char *end;
+        long pid = strtol(cmd->argv[1], &end, 10);
+        struct job *job = NULL;
+        for (int i = 0; i < job_count && *end == '\0'; i++) {
+            if (jobs[i].state != JOB_QUEUED && jobs[i].pid == pid) job = &jobs[i];
+        }
+        if (*end != '\0') {
+            fprintf(stderr, "%s", usage);
+        } else if (!job || !job->log) {
+            fprintf(stderr, "joblog: no captured output for pid %s\n", cmd->argv[1]);
+        } else {
+            drain_capture(job);
+            size_t first = job->log_size - job->log_start < job->log_len
+                         ? job->log_size - job->log_start : job->log_len;
+            fflush(stdout);
+            write(STDOUT_FILENO, job->log + job->log_start, first);
+            write(STDOUT_FILENO, job->log, job->log_len - first);
+        }
+    } else if (cmd->argc == 3 && strcmp(cmd->argv[1], "capture") == 0
+               && (strcmp(cmd->argv[2], "on") == 0 || strcmp(cmd->argv[2], "off") == 0)) {
+        capture_output = strcmp(cmd->argv[2], "on") == 0;
+    } else if (cmd->argc == 3 && strcmp(cmd->argv[1], "size") == 0 && atoi(cmd->argv[2]) > 0) {
+        log_size = (size_t)atoi(cmd->argv[2]) * 1024;
+    } else if (cmd->argc == 3 && strcmp(cmd->argv[1], "keep") == 0 && atoi(cmd->argv[2]) >= 0) {
+        log_keep = atoi(cmd->argv[2]);
+    } else {
+        fprintf(stderr, "%s", usage);
+    }
+}
+
+/*
+* Function: jobs_table
+* ----------------------------------
+* Gives read-only access to the job table, for the status page.
+* 
+* Arguments: count - Where to store the number of jobs
+* 
+* Returns: The first job in the table.
+*/
+
+const struct job *jobs_table(int *count) {
+    *count = job_count;
+    return jobs;
+}
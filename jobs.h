@@ -0,0 +1,63 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include "smallsh.h"
+#include <time.h>
+
+#define MAX_JOBS MAX_ARGS
+
+enum job_state { JOB_QUEUED, JOB_RUNNING, JOB_DONE };
+
+// Struct to store one background job
+struct job {
+    int id;                     // Job number shown by jobs
+    pid_t pid;                  // Process ID, 0 while queued
+    enum job_state state;       // Queued, running or done
+    int priority;               // Queued jobs with higher priority start first
+    time_t submit_time;         // When the job was entered
+    time_t start_time;          // When the job was forked
+    int status;                 // Status returned by waitpid once done
+    bool announced;             // True once "background pid is" was printed
+    bool reported;              // True once "is done" was printed
+    time_t done_time;           // When "is done" was printed
+    struct command_line *cmd;   // Owned copy of the command while queued
+    char *text;                 // Command line shown by jobs
+    int capture_fd;             // Read end of the output pipe, -1 if none
+    char *log;                  // Ring buffer holding the latest output
+    size_t log_size;            // Capacity of the ring buffer, 0 if output is not captured
+    size_t log_start;           // Offset of the oldest byte in the ring
+    size_t log_len;             // Bytes held in the ring
+};
+
+void jobs_init(void);
+void jobs_submit(struct command_line *cmd, int priority);
+void jobs_report(void);
+pid_t jobs_wait(int fd, int timeout_ms, int *status);
+void jobs_wait_for_input(int fd);
+void jobs_wait_all(void);
+void jobs_drain_queue(void);
+void jobs_kill_all(void);
+void jobs_print(void);
+void jobs_sched_command(struct command_line *cmd);
+void jobs_log_command(struct command_line *cmd);
+const struct job *jobs_table(int *count);
+
+#endif
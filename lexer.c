@@ -0,0 +1,270 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Lexer
+* ----------------------------------
+* Splits a command line into words and the operators <, > and &.
+* Words are separated by spaces, tabs and newlines. Single quotes keep
+* everything up to the next single quote literally; inside double quotes
+* a backslash escapes only " and \; elsewhere a backslash escapes any
+* character, and one before the newline or at the end of the line is
+* dropped (lines are not continued). Quoted operator characters are
+* ordinary word characters.
+* 
+* Most bytes of a line are plain word characters, so the lexer looks for
+* the next special byte in bulk and copies the run before it in one go.
+* That search uses AVX2 or SSE2 when the CPU has them, chosen at runtime,
+* with a scalar loop as the fallback. All three return the same index, so
+* the tokens never depend on the CPU. SMALLSH_LEXER=scalar, sse2 or avx2
+* forces one implementation; tools/lexer_fuzz.c checks that they agree.
+*/
+
+#include "lexer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LEXER_X86 1
+#endif
+
+/*
+* Function: is_special
+* ----------------------------------
+* Checks whether a byte ends a run of plain word characters.
+* 
+* Arguments: c - The byte
+* 
+* Returns: True for separators, quotes, backslash and operators.
+*/
+
+static bool is_special(char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n':
+        case '\'': case '"': case '\\':
+        case '<': case '>': case '&':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+* Function: find_special_scalar
+* ----------------------------------
+* Finds the first special byte one byte at a time.
+* 
+* Arguments: s - The text to search
+*            len - The number of bytes
+* 
+* Returns: The index of the first special byte, or len if there is none.
+*/
+
+static size_t find_special_scalar(const char *s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (is_special(s[i])) return i;
+    }
+    return len;
+}
+
+#ifdef LEXER_X86
+/*
+* Function: find_special_sse2
+* ----------------------------------
+* Finds the first special byte 16 bytes at a time with SSE2.
+* 
+* Arguments: s - The text to search
+*            len - The number of bytes
+* 
+* Returns: The index of the first special byte, or len if there is none.
+*/
+
+__attribute__((target("sse2")))
+static size_t find_special_sse2(const char *s, size_t len) {
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), newline = _mm_set1_epi8('\n');
+    const __m128i single = _mm_set1_epi8('\''), dbl = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\');
+    const __m128i less = _mm_set1_epi8('<'), greater = _mm_set1_epi8('>'), amp = _mm_set1_epi8('&');
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                   _mm_cmpeq_epi8(v, newline));
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, single), _mm_cmpeq_epi8(v, dbl)),
+                                             _mm_cmpeq_epi8(v, backslash)));
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, less), _mm_cmpeq_epi8(v, greater)),
+                                             _mm_cmpeq_epi8(v, amp)));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + find_special_scalar(s + i, len - i);
+}
+
+/*
+* Function: find_special_avx2
+* ----------------------------------
+* Finds the first special byte 32 bytes at a time with AVX2.
+* 
+* Arguments: s - The text to search
+*            len - The number of bytes
+* 
+* Returns: The index of the first special byte, or len if there is none.
+*/
+
+__attribute__((target("avx2")))
+static size_t find_special_avx2(const char *s, size_t len) {
+    const __m256i space = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t'), newline = _mm256_set1_epi8('\n');
+    const __m256i single = _mm256_set1_epi8('\''), dbl = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\');
+    const __m256i less = _mm256_set1_epi8('<'), greater = _mm256_set1_epi8('>'), amp = _mm256_set1_epi8('&');
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                                      _mm256_cmpeq_epi8(v, newline));
+        hit = _mm256_or_si256(hit, _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, single),
+                                                                   _mm256_cmpeq_epi8(v, dbl)),
+                                                   _mm256_cmpeq_epi8(v, backslash)));
+        hit = _mm256_or_si256(hit, _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, less),
+                                                                   _mm256_cmpeq_epi8(v, greater)),
+                                                   _mm256_cmpeq_epi8(v, amp)));
+        unsigned mask = _mm256_movemask_epi8(hit);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + find_special_sse2(s + i, len - i);
+}
+#endif
+
+static size_t (*find_special)(const char *s, size_t len) = NULL;    // Chosen on first use
+
+/*
+* Function: select_find_special
+* ----------------------------------
+* Picks the fastest special-byte search this CPU supports, unless
+* SMALLSH_LEXER names one.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+static void select_find_special(void) {
+    const char *forced = getenv("SMALLSH_LEXER");
+    find_special = find_special_scalar;
+#ifdef LEXER_X86
+    __builtin_cpu_init();
+    bool has_sse2 = __builtin_cpu_supports("sse2");
+    bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (forced && strcmp(forced, "scalar") == 0) return;
+    if (forced && strcmp(forced, "sse2") == 0) has_avx2 = false;
+    if (has_avx2) find_special = find_special_avx2;
+    else if (has_sse2) find_special = find_special_sse2;
+#else
+    (void)forced;
+#endif
+}
+
+/*
+* Function: is_separator
+* ----------------------------------
+* Checks whether a byte separates words.
+* 
+* Arguments: c - The byte
+* 
+* Returns: True for space, tab and newline.
+*/
+
+static bool is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+/*
+* Function: lex_line
+* ----------------------------------
+* Splits a command line into tokens.
+* 
+* Arguments: line - The command line
+*            len - The length of line
+*            words - Buffer for the words' text; at least len + 1 bytes
+*            tokens - Where to store the tokens
+*            max_tokens - The size of tokens
+* 
+* Returns: - The number of tokens.
+*          - LEX_UNTERMINATED_QUOTE if a quote is not closed.
+*          - LEX_TOO_MANY_TOKENS if the line has more than max_tokens tokens.
+*/
+
+int lex_line(const char *line, size_t len, char *words, struct token *tokens, int max_tokens) {
+    if (!find_special) select_find_special();
+
+    int count = 0;
+    size_t i = 0;
+    char *out = words;
+
+    while (true) {
+        // Skip separators between tokens
+        while (i < len && is_separator(line[i])) i++;
+        if (i >= len) break;
+        if (count == max_tokens) return LEX_TOO_MANY_TOKENS;
+
+        char c = line[i];
+        if (c == '<' || c == '>' || c == '&') {
+            tokens[count].type = c == '<' ? TOKEN_INPUT : c == '>' ? TOKEN_OUTPUT : TOKEN_BACKGROUND;
+            tokens[count++].text = NULL;
+            i++;
+            continue;
+        }
+
+        // A word runs until an unquoted separator or operator
+        char *word = out;
+        while (i < len) {
+            size_t run = find_special(line + i, len - i);
+            memcpy(out, line + i, run);
+            out += run;
+            i += run;
+            if (i >= len) break;
+
+            c = line[i];
+            if (is_separator(c) || c == '<' || c == '>' || c == '&') break;
+
+            if (c == '\\') {
+                // Keep the next byte as is; a trailing backslash is dropped
+                if (i + 1 < len && line[i + 1] != '\n') *out++ = line[i + 1];
+                i += 2;
+            } else if (c == '\'') {
+                const char *close = memchr(line + i + 1, '\'', len - i - 1);
+                if (!close) return LEX_UNTERMINATED_QUOTE;
+                size_t quoted = close - (line + i + 1);
+                memcpy(out, line + i + 1, quoted);
+                out += quoted;
+                i += quoted + 2;
+            } else {    // Double quote
+                i++;
+                while (i < len && line[i] != '"') {
+                    if (line[i] == '\\' && i + 1 < len && (line[i + 1] == '"' || line[i + 1] == '\\')) i++;
+                    *out++ = line[i++];
+                }
+                if (i >= len) return LEX_UNTERMINATED_QUOTE;
+                i++;
+            }
+        }
+        *out++ = '\0';
+        tokens[count].type = TOKEN_WORD;
+        tokens[count++].text = word;
+    }
+    return count;
+}
@@ -0,0 +1,42 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "smallsh.h"
+
+enum token_type {
+    TOKEN_WORD,         // An argument or file name
+    TOKEN_INPUT,        // <
+    TOKEN_OUTPUT,       // >
+    TOKEN_BACKGROUND    // &
+};
+
+struct token {
+    enum token_type type;
+    char *text;         // The word with quotes and escapes removed; NULL for operators
+};
+
+// Errors returned by lex_line
+#define LEX_UNTERMINATED_QUOTE -1
+#define LEX_TOO_MANY_TOKENS -2
+
+int lex_line(const char *line, size_t len, char *words, struct token *tokens, int max_tokens);
+
+#endif
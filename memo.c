@@ -0,0 +1,521 @@
+#define _GNU_SOURCE     // copy_file_range
+
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Files
+* and Exploration: Processes and I/O.
+*/
+
+/*
+* Memoized commands
+* ----------------------------------
+* "memo tool args < in > out" remembers the output of a deterministic
+* command. The key is a hash of argv, the contents of the input file
+* and the environment variables named in $SMALLSH_MEMO_ENV (default
+* PATH). The store lives in the cache directory under memo/:
+* 
+*   objects/HASH   output files, named by the hash of their contents
+*   keys/HASH      "OBJECT\n" for each successful command key
+* 
+* On a hit the output file is restored from the object by reflink,
+* falling back to copy_file_range, instead of running the command.
+* On a miss the command runs normally; if it exits with status 0 its
+* output is added to the store. Only the file given with > is cached,
+* so memo is for commands whose result is that file. A memoized command
+* without < reads /dev/null, since unhashed input must not affect the
+* stored result. Background commands, and commands without >, run
+* normally.
+* 
+* Hashes are 64-bit FNV-1a, which is fine for a private, local store
+* but not against someone deliberately crafting collisions.
+*/
+
+#include "memo.h"
+#include "cache.h"
+#include "commands.h"
+#include "status.h"
+#include <errno.h>
+#include <limits.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+
+static int memo_hits = 0;       // Commands restored from the store this session
+static int memo_misses = 0;     // Commands run and stored this session
+
+/*
+* Function: hash_file
+* ----------------------------------
+* Hashes the contents of a file.
+* 
+* Arguments: path - The file
+*            hash - The hash so far; updated in place
+* 
+* Returns: True if the file was read, otherwise False.
+*/
+
+static bool hash_file(const char *path, uint64_t *hash) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+
+    char buffer[65536];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        *hash = hash_update(*hash, buffer, n);
+    }
+    close(fd);
+    return n == 0;
+}
+
+/*
+* Function: memo_key
+* ----------------------------------
+* Computes the memo key of a command: argv, the input file's contents,
+* and the selected environment variables.
+* 
+* Arguments: cmd - The command, without the memo prefix
+*            key - Where to store the key
+* 
+* Returns: True if the key was computed, False if the input file cannot be read.
+*/
+
+static bool memo_key(struct command_line *cmd, uint64_t *key) {
+    uint64_t hash = HASH_SEED;
+    for (int i = 0; i < cmd->argc; i++) {
+        hash = hash_update(hash, cmd->argv[i], strlen(cmd->argv[i]) + 1);
+    }
+
+    // Separate argv from the input so "a b" + "c" differs from "a" + "b c"
+    hash = hash_update(hash, "<", 2);
+    if (cmd->input_file && !hash_file(cmd->input_file, &hash)) return false;
+
+    const char *names = getenv("SMALLSH_MEMO_ENV");
+    char list[INPUT_LENGTH];
+    snprintf(list, sizeof(list), "%s", names ? names : "PATH");
+    for (char *name = strtok(list, " :,"); name; name = strtok(NULL, " :,")) {
+        const char *value = getenv(name);
+        hash = hash_update(hash, name, strlen(name) + 1);
+        hash = value ? hash_update(hash, value, strlen(value) + 1) : hash_update(hash, "", 0);
+        hash = hash_update(hash, value ? "=" : "!", 1);
+    }
+    *key = hash;
+    return true;
+}
+
+/*
+* Function: clone_file
+* ----------------------------------
+* Copies one file over another, sharing blocks with a reflink where the
+* filesystem supports it and using copy_file_range otherwise.
+* 
+* Arguments: from - The source file
+*            to - The destination file, created or truncated
+* 
+* Returns: True on success, otherwise False.
+*/
+
+static bool clone_file(const char *from, const char *to) {
+    int in_fd = open(from, O_RDONLY);
+    if (in_fd == -1) return false;
+    int out_fd = open(to, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd == -1) {
+        close(in_fd);
+        return false;
+    }
+
+    bool ok = ioctl(out_fd, FICLONE, in_fd) == 0;
+    if (!ok) {
+        ssize_t n;
+        while ((n = copy_file_range(in_fd, NULL, out_fd, NULL, 1 << 30, 0)) > 0);
+        ok = n == 0;
+
+        // Fall back to read/write where copy_file_range is not supported
+        if (!ok && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+            char buffer[65536];
+            ok = lseek(in_fd, 0, SEEK_SET) == 0 && ftruncate(out_fd, 0) == 0
+                 && lseek(out_fd, 0, SEEK_SET) == 0;
+            while (ok && (n = read(in_fd, buffer, sizeof(buffer))) > 0) {
+                ok = write(out_fd, buffer, n) == n;
+            }
+            ok = ok && n == 0;
+        }
+    }
+    close(in_fd);
+    if (close(out_fd) == -1) ok = false;
+    return ok;
+}
+
+/*
+* Function: write_key
+* ----------------------------------
+* Records which object a key maps to, replacing the key file atomically.
+* 
+* Arguments: key_path - The key file
+*            object - The object's hash
+* 
+* Returns: void
+*/
+
+static void write_key(const char *key_path, uint64_t object) {
+    char tmp_path[MEMO_PATH_MAX + sizeof(".XXXXXX")];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", key_path);
+    int fd = mkstemp(tmp_path);
+    if (fd == -1) return;
+
+    char line[32];
+    int len = snprintf(line, sizeof(line), "%016llx\n", (unsigned long long)object);
+    bool ok = write(fd, line, len) == len;
+    if (close(fd) == -1) ok = false;
+    if (!ok || rename(tmp_path, key_path) == -1) unlink(tmp_path);
+}
+
+/*
+* Function: store_output
+* ----------------------------------
+* Adds a command's output file to the store and points its key at it.
+* 
+* Arguments: dir - The memo directory
+*            key_path - The key file
+*            output_file - The output file to store
+* 
+* Returns: void
+*/
+
+static void store_output(const char *dir, const char *key_path, const char *output_file) {
+    uint64_t object = HASH_SEED;
+    if (!hash_file(output_file, &object)) return;
+
+    char object_path[MEMO_PATH_MAX];
+    snprintf(object_path, sizeof(object_path), "%s/objects/%016llx", dir, (unsigned long long)object);
+    if (access(object_path, F_OK) == -1) {
+        // Copy under a temporary name so a partial object is never visible
+        char tmp_path[MEMO_PATH_MAX + sizeof(".XXXXXX")];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", object_path);
+        int fd = mkstemp(tmp_path);
+        if (fd == -1) return;
+        close(fd);
+        if (!clone_file(output_file, tmp_path) || rename(tmp_path, object_path) == -1) {
+            unlink(tmp_path);
+            return;
+        }
+    }
+    write_key(key_path, object);
+}
+
+/*
+* Function: lookup_key
+* ----------------------------------
+* Reads the object a key file points to.
+* 
+* Arguments: key_path - The key file
+*            object - Where to store the object's hash
+* 
+* Returns: True if the key exists, otherwise False.
+*/
+
+static bool lookup_key(const char *key_path, unsigned long long *object) {
+    FILE *file = fopen(key_path, "r");
+    if (!file) return false;
+    bool found = fscanf(file, "%16llx", object) == 1;
+    fclose(file);
+    return found;
+}
+
+/*
+* Function: memo_key_path
+* ----------------------------------
+* Builds the path of a key file, creating the store's directories.
+* 
+* Arguments: dir - The memo directory
+*            key - The command's key
+*            key_path - Where to store the path; MEMO_PATH_MAX bytes
+* 
+* Returns: void
+*/
+
+static void memo_key_path(const char *dir, uint64_t key, char *key_path) {
+    char sub[MEMO_PATH_MAX];
+    snprintf(sub, sizeof(sub), "%s/keys", dir);
+    mkdir(sub, 0700);
+    snprintf(sub, sizeof(sub), "%s/objects", dir);
+    mkdir(sub, 0700);
+    snprintf(key_path, MEMO_PATH_MAX, "%s/keys/%016llx", dir, (unsigned long long)key);
+}
+
+/*
+* Function: memo_lookup
+* ----------------------------------
+* Looks a memoized command up in the store, restoring its output file
+* on a hit.
+* 
+* Arguments: cmd - The command, without the memo prefix; a command
+*                  without < is given /dev/null as its input
+*            key - Where to store the key, for memo_store after a miss
+* 
+* Returns: - MEMO_HIT if the output was restored; the command must not run.
+*          - MEMO_MISS if the command should run and then be stored.
+*          - MEMO_UNCACHED if the command cannot be memoized; it runs normally.
+*/
+
+enum memo_result memo_lookup(struct command_line *cmd, uint64_t *key) {
+    char dir[PATH_MAX];
+    if (cmd->is_bg || !cmd->output_file || cmd->argc == 0 || is_builtin_command(cmd)) return MEMO_UNCACHED;
+    if (!cmd->input_file) cmd->input_file = "/dev/null";    // Input is part of the key
+    if (!cache_dir(dir, sizeof(dir), "memo") || !memo_key(cmd, key)) return MEMO_UNCACHED;
+
+    char key_path[MEMO_PATH_MAX];
+    memo_key_path(dir, *key, key_path);
+
+    unsigned long long object;
+    if (lookup_key(key_path, &object)) {
+        char object_path[MEMO_PATH_MAX];
+        snprintf(object_path, sizeof(object_path), "%s/objects/%016llx", dir, object);
+        if (clone_file(object_path, cmd->output_file)) {
+            utimensat(AT_FDCWD, key_path, NULL, 0);     // Mark the key as recently used for memo gc
+            memo_hits++;
+            return MEMO_HIT;
+        }
+    }
+    memo_misses++;
+    return MEMO_MISS;
+}
+
+/*
+* Function: memo_store
+* ----------------------------------
+* Records the output of a command that missed in memo_lookup, if it
+* exited with status 0.
+* 
+* Arguments: cmd - The command, as passed to memo_lookup
+*            key - The key from memo_lookup
+*            status - The command's exit status
+* 
+* Returns: void
+*/
+
+void memo_store(const struct command_line *cmd, uint64_t key, int status) {
+    char dir[PATH_MAX];
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return;
+    if (!cache_dir(dir, sizeof(dir), "memo")) return;
+
+    char key_path[MEMO_PATH_MAX];
+    memo_key_path(dir, key, key_path);
+    store_output(dir, key_path, cmd->output_file);
+}
+
+/*
+* Function: memo_window_command
+* ----------------------------------
+* Checks whether a memo line can run in a -j window, and if so turns it
+* into the command it memoizes. The window then calls memo_lookup when
+* the command is due to start and memo_store when it retires.
+* 
+* Arguments: cmd - The command; the memo prefix is removed on success
+* 
+* Returns: True if cmd is now a memoized command for the window.
+*/
+
+bool memo_window_command(struct command_line *cmd) {
+    if (cmd->argc < 2 || strcmp(cmd->argv[0], "memo") != 0) return false;
+    if (strcmp(cmd->argv[1], "stats") == 0 && cmd->argc == 2) return false;
+    if (strcmp(cmd->argv[1], "gc") == 0 && cmd->argc <= 3) return false;
+
+    struct command_line sub = *cmd;
+    sub.argc = cmd->argc - 1;
+    memmove(sub.argv, cmd->argv + 1, (sub.argc + 1) * sizeof(char *));
+    if (sub.is_bg || !sub.output_file || is_builtin_command(&sub)) return false;
+
+    if (!sub.input_file) sub.input_file = "/dev/null";  // Known before scheduling, for conflicts
+    *cmd = sub;
+    return true;
+}
+
+/*
+* Function: memo_run
+* ----------------------------------
+* Runs a memoized command, restoring its output from the store on a
+* hit and recording it on a miss.
+* 
+* Arguments: cmd - The command, without the memo prefix
+* 
+* Returns: void
+*/
+
+static void memo_run(struct command_line *cmd) {
+    uint64_t key;
+    if (foreground_only_mode) cmd->is_bg = false;
+
+    switch (memo_lookup(cmd, &key)) {
+        case MEMO_HIT:
+            last_exit_status = 0;       // Same status as the run that was stored
+            status_update();
+            break;
+        case MEMO_MISS:
+            execute_other_commands(cmd);
+            memo_store(cmd, key, last_exit_status);
+            break;
+        case MEMO_UNCACHED:
+            // Not memoizable; run it like any other command
+            if (!builtin_commands(cmd)) execute_other_commands(cmd);
+            break;
+    }
+}
+
+/*
+* Function: memo_stats
+* ----------------------------------
+* Prints the hits and misses of this session and the size of the store.
+* 
+* Arguments: dir - The memo directory
+* 
+* Returns: void
+*/
+
+static void memo_stats(const char *dir) {
+    const char *subdirs[] = {"keys", "objects"};
+    long counts[2] = {0, 0};
+    long long bytes = 0;
+
+    for (int i = 0; i < 2; i++) {
+        char path[MEMO_PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", dir, subdirs[i]);
+        DIR *d = opendir(path);
+        if (!d) continue;
+        struct dirent *entry;
+        while ((entry = readdir(d))) {
+            struct stat st;
+            if (entry->d_name[0] == '.' || fstatat(dirfd(d), entry->d_name, &st, 0) == -1) continue;
+            counts[i]++;
+            if (i == 1) bytes += st.st_size;
+        }
+        closedir(d);
+    }
+    printf("session: %d hits, %d misses\n", memo_hits, memo_misses);
+    printf("store: %ld keys, %ld objects, %lld bytes in %s\n", counts[0], counts[1], bytes, dir);
+    fflush(stdout);
+}
+
+/*
+* Function: memo_gc
+* ----------------------------------
+* Cleans up the store. Keys unused for max_age_days are dropped (if
+* max_age_days is positive), as are keys whose object is missing; then
+* objects no key points to are deleted.
+* 
+* Arguments: dir - The memo directory
+*            max_age_days - Age limit for keys, or 0 for none
+* 
+* Returns: void
+*/
+
+static void memo_gc(const char *dir, int max_age_days) {
+    char keys_path[MEMO_PATH_MAX], objects_path[MEMO_PATH_MAX];
+    snprintf(keys_path, sizeof(keys_path), "%s/keys", dir);
+    snprintf(objects_path, sizeof(objects_path), "%s/objects", dir);
+
+    // Collect the objects that live keys point to
+    unsigned long long *live = NULL;
+    size_t live_count = 0, live_cap = 0;
+    int removed_keys = 0, removed_objects = 0;
+    time_t now = time(NULL);
+
+    DIR *d = opendir(keys_path);
+    struct dirent *entry;
+    while (d && (entry = readdir(d))) {
+        if (entry->d_name[0] == '.') continue;
+        char path[2 * PATH_MAX], object_path[2 * PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", keys_path, entry->d_name);
+
+        struct stat st;
+        unsigned long long object;
+        bool keep = stat(path, &st) == 0 && strchr(entry->d_name, '.') == NULL
+                    && lookup_key(path, &object);
+        if (keep && max_age_days > 0 && now - st.st_mtime > max_age_days * 86400L) keep = false;
+        if (keep) {
+            snprintf(object_path, sizeof(object_path), "%s/%016llx", objects_path, object);
+            keep = access(object_path, F_OK) == 0;
+        }
+        if (!keep) {
+            if (unlink(path) == 0) removed_keys++;
+            continue;
+        }
+        if (live_count == live_cap) {
+            live_cap = live_cap ? live_cap * 2 : 64;
+            live = realloc(live, live_cap * sizeof(*live));
+        }
+        live[live_count++] = object;
+    }
+    if (d) closedir(d);
+
+    d = opendir(objects_path);
+    while (d && (entry = readdir(d))) {
+        if (entry->d_name[0] == '.') continue;
+        char *end;
+        unsigned long long object = strtoull(entry->d_name, &end, 16);
+        bool referenced = false;
+        for (size_t i = 0; i < live_count && *end == '\0' && !referenced; i++) {
+            referenced = live[i] == object;
+        }
+        if (!referenced && unlinkat(dirfd(d), entry->d_name, 0) == 0) removed_objects++;
+    }
+    if (d) closedir(d);
+    free(live);
+
+    printf("removed %d keys, %d objects\n", removed_keys, removed_objects);
+    fflush(stdout);
+}
+
+/*
+* Function: memo_command
+* ----------------------------------
+* Implements the memo built-in: "memo command [args] < in > out",
+* "memo stats" and "memo gc [DAYS]".
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: void
+*/
+
+void memo_command(struct command_line *cmd) {
+    char dir[PATH_MAX];
+    if (cmd->argc < 2) {
+        fprintf(stderr, "usage: memo command [args] < in > out | memo stats | memo gc [DAYS]\n");
+        return;
+    }
+
+    if (strcmp(cmd->argv[1], "stats") == 0 && cmd->argc == 2) {
+        if (cache_dir(dir, sizeof(dir), "memo")) memo_stats(dir);
+        else perror("memo");
+        return;
+    }
+    if (strcmp(cmd->argv[1], "gc") == 0 && cmd->argc <= 3) {
+        if (cache_dir(dir, sizeof(dir), "memo")) memo_gc(dir, cmd->argc == 3 ? atoi(cmd->argv[2]) : 0);
+        else perror("memo");
+        return;
+    }
+
+    // Run the rest of the line as its own command
+    struct command_line sub = *cmd;
+    sub.argc = cmd->argc - 1;
+    memmove(sub.argv, cmd->argv + 1, (sub.argc + 1) * sizeof(char *));
+    memo_run(&sub);
+}
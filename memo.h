@@ -0,0 +1,39 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+#ifndef MEMO_H
+#define MEMO_H
+
+#include "smallsh.h"
+#include <stdint.h>
+#include <limits.h>
+
+#define MEMO_PATH_MAX (PATH_MAX + 64)      // A store directory plus a file name
+
+enum memo_result {
+    MEMO_HIT,           // Output restored from the store
+    MEMO_MISS,          // Run it, then memo_store
+    MEMO_UNCACHED       // Not memoizable; run it normally
+};
+
+void memo_command(struct command_line *cmd);
+bool memo_window_command(struct command_line *cmd);
+enum memo_result memo_lookup(struct command_line *cmd, uint64_t *key);
+void memo_store(const struct command_line *cmd, uint64_t key, int status);
+
+#endif
@@ -0,0 +1,455 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Process
+* API - Monitoring Child Processes and Exploration: Processes and I/O.
+*/
+
+/*
+* Parallel script execution
+* ----------------------------------
+* Commands are read into a window in script order. A command may start
+* once no earlier, unfinished command in the window conflicts with it:
+* 
+*   - one writes a file (>) that the other reads (<), writes, or
+*     names as an argument (as in "sort < a > b" then "wc -l b")
+*   - both read the shell's stdin (no < given)
+* 
+* These conflicts are the edges of the dependency DAG, so independent
+* commands run concurrently on up to max_jobs processes. Each command's
+* terminal output is captured in a temporary file and replayed when the
+* command retires, and commands retire strictly in script order, so
+* output and last_exit_status match a sequential run. When the shell's
+* stdout and stderr are the same file, both streams share one capture
+* so a command's output and errors keep their relative order. A command
+* whose capture cannot be created waits for the window to drain and runs
+* uncaptured, alone.
+* 
+* Built-in commands (cd, status, wait, ...) and background commands
+* are barriers: the window is drained and they run sequentially. The
+* exception is "memo cmd ... > out": it takes part in the window as the
+* command it memoizes. The store is checked when it is due to start; a
+* hit restores the output and retires with status 0 without running,
+* and a miss runs like any other command and is stored when it retires.
+* File names are compared as written; cd being a barrier keeps relative
+* names meaning the same thing within a window. Files a command opens on
+* its own without < or > (such as "cp a b" followed by "cat b") are not
+* tracked, so scripts that depend on them should not use -j.
+*/
+
+#include "parallel.h"
+#include "commands.h"
+#include "jobs.h"
+#include "status.h"
+#include "memo.h"
+#include <errno.h>
+#include <sys/stat.h>
+
+#define WINDOW_SIZE 64  // Commands that can be waiting, running or unretired at once
+
+struct window_slot {
+    struct command_line cmd;    // Strings point into the compiled script
+    pid_t pid;                  // 0 until the command is started
+    bool done;                  // Set once the process has been reaped
+    int status;                 // Status returned by waitpid
+    FILE *out;                  // Captured stdout, NULL if redirected to a file
+    FILE *err;                  // Captured stderr, NULL if it shares out
+    bool direct;                // No capture: runs alone, writing to the terminal
+    bool memo;                  // A memo command not yet looked up in the store
+    bool memo_store;            // Store the output if it exits with status 0
+    uint64_t memo_key;          // Its key, for memo_store
+};
+
+struct window {
+    struct window_slot slots[WINDOW_SIZE];
+    int head;                   // Oldest unretired command
+    int count;                  // Commands in the window
+    int running;                // Commands started but not yet reaped
+    bool merge_output;          // The shell's stdout and stderr are the same file
+    pid_t published;            // Foreground PID shown on the status page
+};
+
+/*
+* Function: window_at
+* ----------------------------------
+* Returns the i-th oldest slot of the window.
+* 
+* Arguments: w - The window
+*            i - Position relative to the head
+* 
+* Returns: The slot.
+*/
+
+static struct window_slot *window_at(struct window *w, int i) {
+    return &w->slots[(w->head + i) % WINDOW_SIZE];
+}
+
+/*
+* Function: names_file
+* ----------------------------------
+* Checks whether a file name appears among a command's arguments.
+* 
+* Arguments: cmd - The command
+*            file - The file name
+* 
+* Returns: True if one of the arguments is exactly file.
+*/
+
+static bool names_file(const struct command_line *cmd, const char *file) {
+    for (int i = 0; i < cmd->argc; i++) {
+        if (strcmp(cmd->argv[i], file) == 0) return true;
+    }
+    return false;
+}
+
+/*
+* Function: commands_conflict
+* ----------------------------------
+* Checks whether two commands touch the same file, or both read the
+* shell's stdin, in a way that makes their order matter. A file written
+* with > conflicts with the same name used as the other's argument.
+* 
+* Arguments: a - A command
+*            b - Another command
+* 
+* Returns: True if a and b must not run at the same time.
+*/
+
+static bool commands_conflict(const struct command_line *a, const struct command_line *b) {
+    if (!a->input_file && !b->input_file) return true;
+    if (a->output_file) {
+        if (b->output_file && strcmp(a->output_file, b->output_file) == 0) return true;
+        if (b->input_file && strcmp(a->output_file, b->input_file) == 0) return true;
+        if (names_file(b, a->output_file)) return true;
+    }
+    if (b->output_file) {
+        if (a->input_file && strcmp(b->output_file, a->input_file) == 0) return true;
+        if (names_file(a, b->output_file)) return true;
+    }
+    return false;
+}
+
+/*
+* Function: copy_capture
+* ----------------------------------
+* Replays a capture file to one of the shell's descriptors and closes it.
+* 
+* Arguments: capture - The capture file, or NULL
+*            fd - The descriptor to write to
+* 
+* Returns: void
+*/
+
+static void copy_capture(FILE *capture, int fd) {
+    if (!capture) return;
+    char buffer[4096];
+    ssize_t n;
+    lseek(fileno(capture), 0, SEEK_SET);
+    while ((n = read(fileno(capture), buffer, sizeof(buffer))) > 0) {
+        ssize_t off = 0;
+        while (off < n) {
+            ssize_t written = write(fd, buffer + off, n - off);
+            if (written == -1) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            off += written;
+        }
+    }
+    fclose(capture);
+}
+
+/*
+* Function: open_capture
+* ----------------------------------
+* Creates a capture file that later children do not inherit.
+* 
+* Arguments: None.
+* 
+* Returns: The capture file, or NULL on failure.
+*/
+
+static FILE *open_capture(void) {
+    FILE *capture = tmpfile();
+    if (capture) fcntl(fileno(capture), F_SETFD, FD_CLOEXEC);
+    return capture;
+}
+
+/*
+* Function: open_captures
+* ----------------------------------
+* Creates the capture files for a window command.
+* 
+* Arguments: slot - The command
+*            merge - Capture stdout and stderr in one file
+* 
+* Returns: True on success, false if a capture file could not be created.
+*/
+
+static bool open_captures(struct window_slot *slot, bool merge) {
+    slot->out = slot->err = NULL;
+    if (!slot->cmd.output_file) {
+        slot->out = open_capture();
+        if (!slot->out) return false;
+        if (merge) return true;
+    }
+    slot->err = open_capture();
+    if (!slot->err) {
+        if (slot->out) fclose(slot->out);
+        slot->out = NULL;
+        return false;
+    }
+    return true;
+}
+
+/*
+* Function: start_slot
+* ----------------------------------
+* Forks a window command with its terminal output sent to its capture
+* files, or straight to the terminal if it runs uncaptured.
+* 
+* Arguments: slot - The command to start
+* 
+* Returns: void
+*/
+
+static void start_slot(struct window_slot *slot) {
+    fflush(stdout);
+
+    pid_t spawn_pid = fork();
+    if (spawn_pid == -1) {
+        perror("fork failed");
+        exit(1);
+    } else if (spawn_pid == 0) {    // Child process
+        if (slot->out) dup2(fileno(slot->out), 1);
+        if (slot->err) dup2(fileno(slot->err), 2);
+        else if (slot->out) dup2(fileno(slot->out), 2);    // Merged capture
+        run_child(&slot->cmd);
+    }
+    slot->pid = spawn_pid;
+}
+
+/*
+* Function: same_file
+* ----------------------------------
+* Checks whether two descriptors refer to the same file.
+* 
+* Arguments: fd1 - A descriptor
+*            fd2 - Another descriptor
+* 
+* Returns: True if both are open on the same file.
+*/
+
+static bool same_file(int fd1, int fd2) {
+    struct stat st1, st2;
+    if (fstat(fd1, &st1) == -1 || fstat(fd2, &st2) == -1) return false;
+    return st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+}
+
+/*
+* Function: start_ready_commands
+* ----------------------------------
+* Starts every waiting command whose dependencies have finished,
+* oldest first, until max_jobs commands are running.
+* 
+* Arguments: w - The window
+*            max_jobs - The maximum number of commands to run at once
+* 
+* Returns: void
+*/
+
+static void start_ready_commands(struct window *w, int max_jobs) {
+    for (int i = 0; i < w->count && w->running < max_jobs; i++) {
+        struct window_slot *slot = window_at(w, i);
+        if (slot->pid) {
+            if (slot->direct && !slot->done) return;    // Nothing runs beside it
+            continue;
+        }
+
+        bool ready = true;
+        for (int j = 0; j < i && ready; j++) {
+            struct window_slot *earlier = window_at(w, j);
+            if (!earlier->done && commands_conflict(&earlier->cmd, &slot->cmd)) ready = false;
+        }
+        if (!ready) continue;
+
+        if (slot->memo) {
+            slot->memo = false;
+            enum memo_result result = memo_lookup(&slot->cmd, &slot->memo_key);
+            if (result == MEMO_HIT) {
+                slot->pid = -1;         // Never started, so wait_for_command never matches it
+                slot->done = true;
+                slot->status = 0;       // Same status as the run that was stored
+                continue;
+            }
+            slot->memo_store = result == MEMO_MISS;
+        }
+
+        if (!slot->direct && !open_captures(slot, w->merge_output)) slot->direct = true;
+        if (slot->direct) {
+            // Without a capture it must run after everything before it has retired
+            if (i == 0 && w->running == 0) {
+                start_slot(slot);
+                w->running++;
+            }
+            return;
+        }
+        start_slot(slot);
+        w->running++;
+    }
+}
+
+/*
+* Function: retire_commands
+* ----------------------------------
+* Retires finished commands from the head of the window in script order,
+* replaying their output and recording their exit status.
+* 
+* Arguments: w - The window
+* 
+* Returns: void
+*/
+
+static void retire_commands(struct window *w) {
+    while (w->count > 0 && window_at(w, 0)->done) {
+        struct window_slot *slot = window_at(w, 0);
+        copy_capture(slot->out, STDOUT_FILENO);
+        copy_capture(slot->err, STDERR_FILENO);
+        if (slot->memo_store) memo_store(&slot->cmd, slot->memo_key, slot->status);
+        last_exit_status = slot->status;    // Store exit status
+        status_update();
+        w->head = (w->head + 1) % WINDOW_SIZE;
+        w->count--;
+    }
+}
+
+/*
+* Function: publish_foreground
+* ----------------------------------
+* Shows the oldest running window command as the foreground command
+* on the status page.
+* 
+* Arguments: w - The window
+* 
+* Returns: void
+*/
+
+static void publish_foreground(struct window *w) {
+    struct window_slot *oldest = NULL;
+    for (int i = 0; i < w->count && !oldest; i++) {
+        struct window_slot *slot = window_at(w, i);
+        if (slot->pid && !slot->done) oldest = slot;
+    }
+
+    pid_t pid = oldest ? oldest->pid : 0;
+    if (pid == w->published) return;
+    w->published = pid;
+    status_set_foreground(pid, oldest ? &oldest->cmd : NULL);
+}
+
+/*
+* Function: wait_for_command
+* ----------------------------------
+* Blocks until a window command exits and marks it done.
+* Background jobs are serviced by jobs_wait meanwhile.
+* 
+* Arguments: w - The window
+* 
+* Returns: void
+*/
+
+static void wait_for_command(struct window *w) {
+    int child_status;
+    pid_t pid = jobs_wait(-1, -1, &child_status);
+    if (pid <= 0) return;
+
+    for (int i = 0; i < w->count; i++) {
+        struct window_slot *slot = window_at(w, i);
+        if (slot->pid == pid && !slot->done) {
+            slot->done = true;
+            slot->status = child_status;
+            w->running--;
+            return;
+        }
+    }
+}
+
+/*
+* Function: run_script_parallel
+* ----------------------------------
+* Runs a compiled script with independent commands executing
+* concurrently, with results equivalent to running it in order.
+* 
+* Arguments: script - The compiled script
+*            max_jobs - The maximum number of commands to run at once
+* 
+* Returns: void
+*/
+
+void run_script_parallel(struct script_cache *script, int max_jobs) {
+    struct window *w = calloc(1, sizeof(struct window));
+    int total = script_cache_count(script);
+    int next = 0;
+    w->merge_output = same_file(STDOUT_FILENO, STDERR_FILENO);
+
+    while (next < total || w->count > 0) {
+        // Fill the window up to the next barrier
+        while (next < total && w->count < WINDOW_SIZE) {
+            const char *error = script_cache_error(script, next);
+            if (error) {
+                // Report syntax errors after the output of the commands before them
+                if (w->count > 0) break;
+                fprintf(stderr, "smallsh: %s\n", error);
+                next++;
+                continue;
+            }
+
+            struct command_line *cmd = &window_at(w, w->count)->cmd;
+            script_cache_command(script, next, cmd);
+            if (foreground_only_mode) cmd->is_bg = false;
+            bool memo = memo_window_command(cmd);
+
+            if (!is_builtin_command(cmd) && !cmd->is_bg) {
+                struct window_slot *slot = window_at(w, w->count++);
+                slot->pid = 0;
+                slot->done = false;
+                slot->direct = false;
+                slot->memo = memo;
+                slot->memo_store = false;
+                next++;
+            } else if (w->count == 0) {
+                // Barrier with an empty window: run it on its own
+                jobs_report();
+                if (!builtin_commands(cmd)) {
+                    execute_other_commands(cmd);
+                }
+                next++;
+            } else {
+                break;  // Drain the window before the barrier
+            }
+        }
+
+        start_ready_commands(w, max_jobs);
+        retire_commands(w);
+        publish_foreground(w);
+        if (w->running > 0) wait_for_command(w);
+    }
+    publish_foreground(w);
+    free(w);
+}
@@ -21,13 +21,53 @@
 * 
 */
 
+#include "parser.h"
+#include "lexer.h"
+#include "jobs.h"
+#include <errno.h>
+
+static char input_buffer[INPUT_LENGTH];    // Input read ahead of the current line
+static size_t input_pos = 0;                // Next unread byte in input_buffer
+static size_t input_len = 0;                // Bytes held in input_buffer
+
+/*
+* Function: read_line
+* ----------------------------------
+* Reads one line from stdin, like fgets. Input is buffered here rather
+* than in stdio so the shell knows when a read would block, and can
+* service background jobs until input arrives.
+* 
+* Arguments: line - Where to store the line
+*            size - The size of line
+* 
+* Returns: True if a line was read, False on EOF.
+*/
+
+static bool read_line(char *line, int size) {
+    int n = 0;
+    while (n < size - 1) {
+        if (input_pos == input_len) {
+            jobs_wait_for_input(STDIN_FILENO);
+            ssize_t got = read(STDIN_FILENO, input_buffer, sizeof(input_buffer));
+            if (got == -1 && errno == EINTR) continue;
+            if (got <= 0) break;
+            input_pos = 0;
+            input_len = got;
+        }
+        char c = input_buffer[input_pos++];
+        line[n++] = c;
+        if (c == '\n') break;
+    }
+    line[n] = '\0';
+    return n > 0;
+}
+
 /*
 * Function: parse_input
 * ----------------------------------
-* Parses the user's input into a structured command_line struct.
-* Handles input redirection (<), output redirection (>), background execution (&),
-* and stores arguments in a NULL-terminated array.
-* Ignores blank lines and comments starting with '#'.
+* Displays the prompt and reads one line of user input, then hands
+* it to parse_line. Exits the shell on EOF (Ctrl+D), once any
+* queued background jobs have started.
 * 
 * Arguments: None.
 * 
@@ -35,42 +75,171 @@
 *          - NULL if the input is a comment or blank.
 */
 
-#include "parser.h"
-
 struct command_line *parse_input() {
     char input[INPUT_LENGTH];
-    struct command_line *curr_command = calloc(1, sizeof(struct command_line));
 
     // Display shell prompt
     printf(": ");
     fflush(stdout);
 
     // Get input from user
-    if (!fgets(input, INPUT_LENGTH, stdin)) {
+    if (!read_line(input, INPUT_LENGTH)) {
         printf("\n");
+        jobs_drain_queue();     // Start queued jobs before exiting
         exit(0);
     }
 
-    // Ignore blank lines and comments
-    if (input[0] == '#' || input[0] == '\n') {
-        free(curr_command);
-        return NULL;
-    }
+    return parse_line(input);
+}
+
+/*
+* Function: parse_line
+* ----------------------------------
+* Parses one line of input into a structured command_line struct,
+* reporting any syntax error on stderr.
+* 
+* Arguments: input - The line to parse.
+* 
+* Returns: - A pointer to a dynamically allocated command_line struct.
+*          - NULL if the input is a comment, blank, or has a syntax error.
+*/
+
+struct command_line *parse_line(char *input) {
+    const char *error = NULL;
+    struct command_line *cmd = parse_command(input, &error);
+    if (error) fprintf(stderr, "smallsh: %s\n", error);
+    return cmd;
+}
+
+/*
+* Function: build_command
+* ----------------------------------
+* Turns the tokens of one line into a command_line struct.
+* 
+* Arguments: tokens - The tokens from lex_line
+*            count - The number of tokens
+*            error - Set to a description of the problem on a syntax error.
+* 
+* Returns: - A pointer to a dynamically allocated command_line struct.
+*          - NULL on a syntax error.
+*/
+
+static struct command_line *build_command(const struct token *tokens, int count, const char **error) {
+    struct command_line *curr_command = calloc(1, sizeof(struct command_line));
 
-    // Tokenize the input into arguments
-    char *token = strtok(input, " \n");
-    while (token) {
-        if (!strcmp(token, "<")) {
-            curr_command->input_file = strdup(strtok(NULL, " \n"));
-        } else if (!strcmp(token, ">")) {
-            curr_command->output_file = strdup(strtok(NULL, " \n"));
-        } else if (!strcmp(token, "&")) {
-            curr_command->is_bg = true;
-        } else {
-            curr_command->argv[curr_command->argc++] = strdup(token);
+    for (int i = 0; i < count && !*error; i++) {
+        switch (tokens[i].type) {
+            case TOKEN_INPUT:
+            case TOKEN_OUTPUT: {
+                bool input = tokens[i].type == TOKEN_INPUT;
+                if (i + 1 == count || tokens[i + 1].type != TOKEN_WORD) {
+                    *error = input ? "missing file name after <" : "missing file name after >";
+                    break;
+                }
+                char **file = input ? &curr_command->input_file : &curr_command->output_file;
+                free(*file);    // The last redirection wins
+                *file = strdup(tokens[++i].text);
+                break;
+            }
+            case TOKEN_BACKGROUND:
+                curr_command->is_bg = true;
+                break;
+            case TOKEN_WORD:
+                if (curr_command->argc == MAX_ARGS) {
+                    *error = "too many arguments";
+                    break;
+                }
+                curr_command->argv[curr_command->argc++] = strdup(tokens[i].text);
+                break;
         }
-        token = strtok(NULL, " \n");
+    }
+
+    if (*error) {
+        free_command(curr_command);
+        return NULL;
     }
     curr_command->argv[curr_command->argc] = NULL;  // Null-terminate the argument list
     return curr_command;
 }
+
+/*
+* Function: parse_command
+* ----------------------------------
+* Parses one line of input into a structured command_line struct.
+* The lexer handles quoting and escapes; this function handles input
+* redirection (<), output redirection (>), background execution (&),
+* and stores arguments in a NULL-terminated array.
+* Ignores blank lines and comments starting with '#'.
+* 
+* Arguments: input - The line to parse.
+*            error - Set to a description of the problem on a syntax error.
+* 
+* Returns: - A pointer to a dynamically allocated command_line struct.
+*          - NULL if the input is a comment, blank, or has a syntax error.
+*/
+
+struct command_line *parse_command(char *input, const char **error) {
+    *error = NULL;
+
+    // Ignore blank lines and comments
+    if (input[0] == '#' || input[0] == '\n') return NULL;
+
+    size_t len = strlen(input);
+    char *words = malloc(len + 1);
+    struct token *tokens = malloc((len + 1) * sizeof(struct token));
+    int count = lex_line(input, len, words, tokens, len);
+
+    struct command_line *curr_command = NULL;
+    if (count == LEX_UNTERMINATED_QUOTE) {
+        *error = "unterminated quote";
+    } else if (count > 0) {     // Lines of only whitespace are blank
+        curr_command = build_command(tokens, count, error);
+    }
+
+    free(words);
+    free(tokens);
+    return curr_command;
+}
+
+/*
+* Function: free_command
+* ----------------------------------
+* Releases a command_line struct returned by parse_input or parse_line.
+* 
+* Arguments: cmd - The command to free.
+* 
+* Returns: void
+*/
+
+void free_command(struct command_line *cmd) {
+    for (int i = 0; i < cmd->argc; i++) {
+        free(cmd->argv[i]);
+    }
+    free(cmd->input_file);
+    free(cmd->output_file);
+    free(cmd);
+}
+
+/*
+* Function: copy_command
+* ----------------------------------
+* Makes a deep copy of a command_line struct, for commands that must
+* outlive the line they were parsed from.
+* 
+* Arguments: cmd - The command to copy.
+* 
+* Returns: A dynamically allocated copy, to be released with free_command.
+*/
+
+struct command_line *copy_command(const struct command_line *cmd) {
+    struct command_line *copy = calloc(1, sizeof(struct command_line));
+    for (int i = 0; i < cmd->argc; i++) {
+        copy->argv[i] = strdup(cmd->argv[i]);
+    }
+    copy->argc = cmd->argc;
+    copy->argv[copy->argc] = NULL;
+    copy->input_file = cmd->input_file ? strdup(cmd->input_file) : NULL;
+    copy->output_file = cmd->output_file ? strdup(cmd->output_file) : NULL;
+    copy->is_bg = cmd->is_bg;
+    return copy;
+}
@@ -26,7 +26,11 @@
 
 #include "smallsh.h"
 
-// Function prototype for parsing user input
+// Function prototypes for parsing user input
 struct command_line *parse_input();
+struct command_line *parse_line(char *input);
+struct command_line *parse_command(char *input, const char **error);
+void free_command(struct command_line *cmd);
+struct command_line *copy_command(const struct command_line *cmd);
 
 #endif
@@ -22,20 +22,32 @@
 */
 
 #include "signals.h"
+#include "status.h"
+#include <errno.h>
+
+int sigchld_pipe[2] = {-1, -1};     // Self-pipe written by the SIGCHLD handler
+int sigint_pipe[2] = {-1, -1};      // Self-pipe written by the SIGINT handler
+volatile sig_atomic_t sigint_received = 0;  // Set by the SIGINT handler
 
 /*
 * Function: signal_SIGINT
 * ----------------------------------
 * Handles the SIGINT signal (Ctrl+C). Ensures that the shell
-* does not terminate and redisplays the prompt.
+* does not terminate and redisplays the prompt. Also records the
+* signal, and wakes the shell's wait loop through a self-pipe, so
+* long-running built-ins such as on-change can stop.
 * 
 * Arguments: signo - The received signal number (SIGINT).
 * 
 * Returns: void
 */
 void signal_SIGINT(int signo) {
+    int saved_errno = errno;
+    sigint_received = 1;
+    if (sigint_pipe[1] != -1) write(sigint_pipe[1], "i", 1);
     write(STDOUT_FILENO, "\n: ", 3);
     fflush(stdout);
+    errno = saved_errno;
 }
 
 /*
@@ -58,6 +70,23 @@ void signal_SIGTSTP(int signo) {
         foreground_only_mode = 1;
         message = "\nEntering foreground-only mode (& is now ignored)\n: ";
     }
+    status_set_foreground_only(foreground_only_mode);
     write(STDOUT_FILENO, message, strlen(message));
     fflush(stdout);
 }
+
+/*
+* Function: signal_SIGCHLD
+* ----------------------------------
+* Handles the SIGCHLD signal. Writes a byte to the self-pipe so the
+* shell's wait loop wakes up and reaps the child.
+* 
+* Arguments: signo - The received signal number (SIGCHLD).
+* 
+* Returns: void
+*/
+void signal_SIGCHLD(int signo) {
+    int saved_errno = errno;
+    write(sigchld_pipe[1], "c", 1);
+    errno = saved_errno;
+}
@@ -23,5 +23,10 @@
 
 void signal_SIGINT(int signo);
 void signal_SIGTSTP(int signo);
+void signal_SIGCHLD(int signo);
+
+extern int sigchld_pipe[2];     // Self-pipe written by the SIGCHLD handler
+extern int sigint_pipe[2];      // Self-pipe written by the SIGINT handler
+extern volatile sig_atomic_t sigint_received;   // Set by the SIGINT handler
 
 #endif
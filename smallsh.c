@@ -29,8 +29,12 @@
 * This function continuously prompts the user for commands,
 * processes input, executes built-in or external commands,
 * and handles foreground/background execution.
+* If a script path is given, its commands are run instead of
+* prompting, and the shell exits when the script ends. With -j N,
+* independent script commands run concurrently on up to N processes.
 * 
-* Arguments: None.
+* Arguments: argc - The number of command line arguments
+*            argv - The command line arguments: [-j N] [script]
 * 
 * Returns: int - EXIT_SUCCESS (0) if the program runs successfully.
 */
@@ -39,15 +43,71 @@
 #include "parser.h"
 #include "commands.h"
 #include "signals.h"
+#include "cache.h"
+#include "parallel.h"
+#include "jobs.h"
+#include "status.h"
 
 // Global variables
 int last_exit_status = 0;       // Tracks last exit status
 int foreground_only_mode = 0;   // Tracks foreground only mode, 1 = enabled, 0 = disabled
 
-int main() {
+/*
+* Function: run_script
+* ----------------------------------
+* Runs every command of a script in order, as if each line had been
+* typed at the prompt. The script is loaded through the compiled
+* script cache, so a script that has run before is not parsed again.
+* 
+* Arguments: path - The script to run
+*            max_jobs - Commands to run at once; 1 runs the script in order
+* 
+* Returns: void
+*/
+
+static void run_script(const char *path, int max_jobs) {
+    struct script_cache *script = script_cache_open(path);
+    if (!script) {
+        perror(path);
+        exit(1);
+    }
+
+    if (max_jobs > 1) {
+        run_script_parallel(script, max_jobs);
+        script_cache_close(script);
+        return;
+    }
+
+    struct command_line cmd;
+    for (int i = 0; i < script_cache_count(script); i++) {
+        jobs_report();
+        const char *error = script_cache_error(script, i);
+        if (error) {
+            fprintf(stderr, "smallsh: %s\n", error);
+            continue;
+        }
+        script_cache_command(script, i, &cmd);
+        if (!builtin_commands(&cmd)) {
+            execute_other_commands(&cmd);
+        }
+    }
+    script_cache_close(script);
+}
+
+int main(int argc, char *argv[]) {
     struct command_line *curr_command;
-    pid_t bg_pids[MAX_ARGS];  // Store background PIDs
-    int bg_count = 0;         // Number of background processes
+    int max_jobs = 1;         // Script commands to run at once
+
+    // Parse command line options
+    int opt;
+    while ((opt = getopt(argc, argv, "j:")) != -1) {
+        if (opt == 'j' && atoi(optarg) > 0) {
+            max_jobs = atoi(optarg);
+        } else {
+            fprintf(stderr, "usage: %s [-j jobs] [script]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
 
     // Set up SIGINT handler (Ctrl+C should NOT terminate the shell)
     struct sigaction sa_sigint = {0};
@@ -63,40 +123,40 @@ int main() {
     sa_sigtstp.sa_flags = SA_RESTART;
     sigaction(SIGTSTP, &sa_sigtstp, NULL);
 
+    // Publish the shell's state for external monitors
+    jobs_init();
+    status_init();
+
+    // Set up SIGCHLD handler (wakes the wait loop so bg jobs are reaped promptly)
+    struct sigaction sa_sigchld = {0};
+    sa_sigchld.sa_handler = signal_SIGCHLD;
+    sigfillset(&sa_sigchld.sa_mask);
+    sa_sigchld.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sa_sigchld, NULL);
+
+    // Run a script file non-interactively if one was given
+    if (optind < argc) {
+        run_script(argv[optind], max_jobs);
+        jobs_drain_queue();     // Start queued jobs before exiting
+        return EXIT_SUCCESS;
+    }
+
     while (true) {
         // Check for finished background processes BEFORE showing prompt
-        for (int i = 0; i < bg_count; i++) {
-            int child_status;
-            pid_t result = waitpid(bg_pids[i], &child_status, WNOHANG);
-            if (result > 0) { // Background process finished
-                if (WIFEXITED(child_status)) {
-                    printf("background pid %d is done: exit value %d\n", result, WEXITSTATUS(child_status));
-                } else if (WIFSIGNALED(child_status)) {
-                    printf("background pid %d is done: terminated by signal %d\n", result, WTERMSIG(child_status));
-                }
-                fflush(stdout);
-                // Remove from list
-                bg_pids[i] = bg_pids[--bg_count];  
-            }
-        }
+        jobs_report();
         
         // Get and process user input
         curr_command = parse_input();
         if (!curr_command) continue;  // Ignore blank/comment lines
 
         // Check if command is a built-in command, otherwise execute external
-        if (!builtin_commands(curr_command, bg_pids, &bg_count)) {
-            execute_other_commands(curr_command, bg_pids, &bg_count);
+        if (!builtin_commands(curr_command)) {
+            execute_other_commands(curr_command);
         }
         
 
         // Free memory allocate memory for command
-        for (int i = 0; i < curr_command->argc; i++) {
-            free(curr_command->argv[i]);
-        }
-        free(curr_command->input_file);
-        free(curr_command->output_file);
-        free(curr_command);
+        free_command(curr_command);
     }
     return EXIT_SUCCESS;
 }
@@ -51,9 +51,10 @@ extern int foreground_only_mode;     // Tracks foreground-only mode, 1 = enabled
 
 // Function prototypes
 struct command_line *parse_input();
-bool builtin_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count);
-void execute_other_commands(struct command_line *cmd, pid_t *bg_pids, int *bg_count);
+bool builtin_commands(struct command_line *cmd);
+void execute_other_commands(struct command_line *cmd);
 void signal_SIGINT(int signo);
 void signal_SIGTSTP(int signo);
+void signal_SIGCHLD(int signo);
 
 #endif
@@ -0,0 +1,187 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Files
+* and Exploration: Signal Handling API.
+*/
+
+#include "status.h"
+#include "status_page.h"
+#include "jobs.h"
+#include <limits.h>
+#include <sys/mman.h>
+
+static struct status_page *page = NULL;     // NULL if the page could not be created
+static pid_t shell_pid;
+static pid_t foreground_pid = 0;
+static time_t foreground_start = 0;
+static char foreground_command[STATUS_TEXT_LENGTH];
+
+/*
+* Function: copy_text
+* ----------------------------------
+* Copies a string into a fixed-size field, truncating it to fit.
+* 
+* Arguments: dest - The field
+*            src - The string, or NULL for an empty field
+* 
+* Returns: void
+*/
+
+static void copy_text(char *dest, const char *src) {
+    snprintf(dest, STATUS_TEXT_LENGTH, "%s", src ? src : "");
+}
+
+/*
+* Function: remove_page
+* ----------------------------------
+* Deletes the status page when the shell exits. Registered with atexit;
+* does nothing in forked children that exit without exec'ing.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+static void remove_page(void) {
+    if (getpid() != shell_pid) return;
+    char path[PATH_MAX];
+    status_page_path(path, sizeof(path), shell_pid);
+    unlink(path);
+}
+
+/*
+* Function: status_init
+* ----------------------------------
+* Creates and maps the status page. If that fails the shell runs
+* without one. The name is predictable and /dev/shm is shared, so a
+* leftover file is removed and the page is created afresh, never
+* through a symlink, and readable only by its owner.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void status_init(void) {
+    shell_pid = getpid();
+    char path[PATH_MAX];
+    status_page_path(path, sizeof(path), shell_pid);
+
+    unlink(path);   // Stale page from an earlier shell with this PID
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd == -1) return;
+    if (ftruncate(fd, sizeof(struct status_page)) == -1) {
+        close(fd);
+        unlink(path);
+        return;
+    }
+    void *addr = mmap(NULL, sizeof(struct status_page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        unlink(path);
+        return;
+    }
+
+    page = addr;
+    page->version = STATUS_VERSION;
+    page->shell_pid = shell_pid;
+    atexit(remove_page);
+    status_update();
+    __atomic_store_n(&page->magic, STATUS_MAGIC, __ATOMIC_RELEASE);  // Page is ready
+}
+
+/*
+* Function: status_update
+* ----------------------------------
+* Publishes a fresh snapshot of the shell's state to the status page.
+* 
+* Arguments: None.
+* 
+* Returns: void
+*/
+
+void status_update(void) {
+    if (!page) return;
+
+    // Seqlock write: odd sequence, then the data, then even sequence
+    uint64_t sequence = page->sequence;
+    __atomic_store_n(&page->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    page->last_exit_status = last_exit_status;
+    page->foreground_pid = foreground_pid;
+    page->foreground_start = foreground_start;
+    memcpy(page->foreground_command, foreground_command, STATUS_TEXT_LENGTH);
+
+    int count;
+    const struct job *table = jobs_table(&count);
+    if (count > STATUS_MAX_JOBS) count = STATUS_MAX_JOBS;
+    for (int i = 0; i < count; i++) {
+        struct status_job *entry = &page->jobs[i];
+        entry->id = table[i].id;
+        entry->pid = table[i].pid;
+        entry->state = table[i].state == JOB_QUEUED ? STATUS_JOB_QUEUED
+                     : table[i].state == JOB_RUNNING ? STATUS_JOB_RUNNING : STATUS_JOB_DONE;
+        entry->priority = table[i].priority;
+        entry->submit_time = table[i].submit_time;
+        entry->start_time = table[i].state == JOB_QUEUED ? 0 : table[i].start_time;
+        copy_text(entry->command, table[i].text);
+    }
+    page->job_count = count;
+
+    __atomic_store_n(&page->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/*
+* Function: status_set_foreground
+* ----------------------------------
+* Records the foreground command that is running, and publishes it.
+* 
+* Arguments: pid - The foreground process ID, or 0 when it has finished
+*            cmd - The command, or NULL when it has finished
+* 
+* Returns: void
+*/
+
+void status_set_foreground(pid_t pid, struct command_line *cmd) {
+    foreground_pid = pid;
+    foreground_start = pid ? time(NULL) : 0;
+    foreground_command[0] = '\0';
+    for (int i = 0; cmd && i < cmd->argc; i++) {
+        size_t len = strlen(foreground_command);
+        snprintf(foreground_command + len, STATUS_TEXT_LENGTH - len, "%s%s", i ? " " : "", cmd->argv[i]);
+    }
+    status_update();
+}
+
+/*
+* Function: status_set_foreground_only
+* ----------------------------------
+* Publishes foreground-only mode. Called from the SIGTSTP handler, so
+* it only does a single atomic store and stays outside the seqlock.
+* 
+* Arguments: mode - 1 if foreground-only mode is enabled, otherwise 0
+* 
+* Returns: void
+*/
+
+void status_set_foreground_only(int mode) {
+    if (page) __atomic_store_n(&page->foreground_only_mode, mode, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,91 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Layout of the live status page, shared by the shell and by readers
+* such as tools/smallsh_status.c. The shell maps the page at
+* <dir>/smallsh-<pid>.status, where <dir> is $SMALLSH_STATUS_DIR,
+* $XDG_RUNTIME_DIR or /dev/shm.
+* 
+* The page is guarded by a seqlock. The shell makes sequence odd,
+* updates the page, then makes it even again. A reader copies the page
+* between two reads of sequence and retries if they differ or are odd,
+* so it never blocks the shell and needs no syscalls once mapped.
+* foreground_only_mode is the exception: the SIGTSTP handler stores it
+* directly, as a single aligned word, outside the seqlock.
+*/
+
+#ifndef STATUS_PAGE_H
+#define STATUS_PAGE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STATUS_MAGIC 0x48534d53u        // "SMSH"
+#define STATUS_VERSION 1                // Bumped when the layout changes
+#define STATUS_MAX_JOBS 512
+#define STATUS_TEXT_LENGTH 128          // Command lines are truncated to fit
+
+enum status_job_state { STATUS_JOB_QUEUED, STATUS_JOB_RUNNING, STATUS_JOB_DONE };
+
+struct status_job {
+    int32_t id;                         // Job number shown by jobs
+    int32_t pid;                        // Process ID, 0 while queued
+    int32_t state;                      // enum status_job_state
+    int32_t priority;                   // Queue priority
+    int64_t submit_time;                // Seconds since the epoch
+    int64_t start_time;                 // Seconds since the epoch, 0 while queued
+    char command[STATUS_TEXT_LENGTH];
+};
+
+struct status_page {
+    uint32_t magic;                     // STATUS_MAGIC
+    uint32_t version;                   // STATUS_VERSION
+    uint64_t sequence;                  // Seqlock counter; odd while being written
+    int32_t shell_pid;
+    int32_t foreground_only_mode;       // 1 = enabled; stored outside the seqlock
+    int32_t last_exit_status;           // Raw status as returned by waitpid
+    int32_t foreground_pid;             // 0 if no foreground command is running
+    int64_t foreground_start;           // Seconds since the epoch
+    char foreground_command[STATUS_TEXT_LENGTH];
+    int32_t job_count;
+    int32_t reserved;
+    struct status_job jobs[STATUS_MAX_JOBS];
+};
+
+/*
+* Function: status_page_path
+* ----------------------------------
+* Builds the path of a shell's status page.
+* 
+* Arguments: path - Where to store the path
+*            size - The size of path
+*            pid - The shell's process ID
+* 
+* Returns: void
+*/
+
+static inline void status_page_path(char *path, size_t size, int pid) {
+    const char *dir = getenv("SMALLSH_STATUS_DIR");
+    if (!dir || !*dir) dir = getenv("XDG_RUNTIME_DIR");
+    if (!dir || !*dir) dir = "/dev/shm";
+    snprintf(path, size, "%s/smallsh-%d.status", dir, pid);
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* lexer_fuzz: checks that the SIMD delimiter searches in lexer.c agree
+* with the scalar one.
+* 
+* Usage: lexer_fuzz [LINES] [SEED]
+* 
+* Generates random lines of quotes, backslashes, tabs, <, >, &, '#' and
+* non-ASCII bytes, at every length around the 16- and 32-byte block
+* edges and at random lengths up to INPUT_LENGTH. For each line it checks
+* that find_special_scalar, _sse2 and _avx2 return the same index from
+* every starting offset, and that lex_line returns the same tokens with
+* each of them. lexer.c is included directly so its static functions
+* can be called. Exits with status 1 and prints the line on a mismatch.
+* 
+* Compile: gcc --std=gnu99 -o lexer_fuzz tools/lexer_fuzz.c
+*/
+
+#include "../lexer.c"
+
+#define MAX_LINE INPUT_LENGTH
+
+typedef size_t (*find_fn)(const char *s, size_t len);
+
+struct impl {
+    const char *name;
+    find_fn find;
+};
+
+static struct impl impls[3];
+static int impl_count = 0;
+
+/*
+* Function: random_line
+* ----------------------------------
+* Fills a buffer with random bytes, mostly plain word characters, with
+* special and non-ASCII bytes mixed in at a random density.
+* 
+* Arguments: line - The buffer
+*            len - The number of bytes to generate
+* 
+* Returns: void
+*/
+
+static void random_line(char *line, size_t len) {
+    static const char specials[] = " \t\n'\"\\<>&#";
+    int density = 1 + rand() % 40;      // Chance in 64 of a special byte
+    for (size_t i = 0; i < len; i++) {
+        int r = rand() % 64;
+        if (r < density) line[i] = specials[rand() % (sizeof(specials) - 1)];
+        else if (r < density + 4) line[i] = (char)(0x80 + rand() % 128);
+        else line[i] = "abcdefxyz0123.-/"[rand() % 16];
+    }
+    line[len] = '\0';
+}
+
+/*
+* Function: fail
+* ----------------------------------
+* Reports a mismatch with the line that caused it and exits.
+* 
+* Arguments: what - What differed
+*            line - The line
+*            len - Its length
+* 
+* Returns: Does not return.
+*/
+
+static void fail(const char *what, const char *line, size_t len) {
+    fprintf(stderr, "mismatch in %s on a %zu-byte line:", what, len);
+    for (size_t i = 0; i < len; i++) fprintf(stderr, " %02x", (unsigned char)line[i]);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+/*
+* Function: check_line
+* ----------------------------------
+* Compares every implementation against the scalar one on one line.
+* 
+* Arguments: line - The line
+*            len - Its length
+* 
+* Returns: void
+*/
+
+static void check_line(const char *line, size_t len) {
+    static char words[3][MAX_LINE + 1];
+    static struct token tokens[3][MAX_LINE];
+    int counts[3];
+
+    // The search from every offset, so each special byte lands on every block lane
+    for (size_t start = 0; start <= len; start++) {
+        size_t expected = impls[0].find(line + start, len - start);
+        for (int i = 1; i < impl_count; i++) {
+            if (impls[i].find(line + start, len - start) != expected) fail(impls[i].name, line, len);
+        }
+    }
+
+    for (int i = 0; i < impl_count; i++) {
+        find_special = impls[i].find;
+        counts[i] = lex_line(line, len, words[i], tokens[i], MAX_LINE);
+    }
+    for (int i = 1; i < impl_count; i++) {
+        if (counts[i] != counts[0]) fail("lex_line token count", line, len);
+        for (int t = 0; t < counts[0]; t++) {
+            const struct token *a = &tokens[0][t], *b = &tokens[i][t];
+            if (a->type != b->type) fail("lex_line token type", line, len);
+            if (a->type == TOKEN_WORD && strcmp(a->text, b->text) != 0) fail("lex_line word", line, len);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long lines = argc > 1 ? atol(argv[1]) : 100000;
+    unsigned seed = argc > 2 ? (unsigned)atol(argv[2]) : 1;
+    srand(seed);
+
+    impls[impl_count++] = (struct impl){ "scalar", find_special_scalar };
+#ifdef LEXER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) impls[impl_count++] = (struct impl){ "sse2", find_special_sse2 };
+    if (__builtin_cpu_supports("avx2")) impls[impl_count++] = (struct impl){ "avx2", find_special_avx2 };
+#endif
+    if (impl_count == 1) {
+        printf("only the scalar search is available on this CPU; nothing to compare\n");
+        return 0;
+    }
+
+    static char line[MAX_LINE + 1];
+    long checked = 0;
+
+    // Every length around the block edges, several times each
+    for (size_t len = 0; len <= 3 * 32 + 1; len++) {
+        for (int rep = 0; rep < 200; rep++) {
+            random_line(line, len);
+            check_line(line, len);
+            checked++;
+        }
+    }
+
+    // Random lengths up to the longest input line
+    for (long n = 0; n < lines; n++) {
+        size_t len = rand() % 4 ? rand() % 256 : rand() % MAX_LINE;
+        random_line(line, len);
+        check_line(line, len);
+        checked++;
+    }
+
+    printf("ok: %ld lines agree across", checked);
+    for (int i = 0; i < impl_count; i++) printf(" %s", impls[i].name);
+    printf(" (seed %u)\n", seed);
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* smallsh_status: prints the live status page of a running smallsh.
+* 
+* Usage: smallsh_status PID
+*        smallsh_status -f FILE
+* 
+* The page is read with the seqlock protocol described in status_page.h,
+* so the snapshot printed is always consistent and the shell is never
+* blocked or signalled.
+* 
+* Compile: gcc --std=gnu99 -o smallsh_status tools/smallsh_status.c
+*/
+
+#include "../status_page.h"
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <sys/wait.h>
+
+#define MAX_RETRIES 5000   // Snapshot attempts before the page counts as stale
+
+/*
+* Function: read_snapshot
+* ----------------------------------
+* Copies a consistent snapshot out of a mapped status page, retrying
+* while the shell is in the middle of an update. Gives up after
+* MAX_RETRIES attempts, since a shell killed mid-update leaves the
+* sequence odd forever.
+* 
+* Arguments: page - The mapped page
+*            snapshot - Where to store the copy
+* 
+* Returns: True on success, False if no consistent snapshot was seen.
+*/
+
+static bool read_snapshot(const struct status_page *page, struct status_page *snapshot) {
+    for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+        uint64_t before = __atomic_load_n(&page->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) {   // Update in progress
+            sched_yield();
+            continue;
+        }
+        memcpy(snapshot, page, sizeof(*snapshot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&page->sequence, __ATOMIC_RELAXED) == before) return true;
+    }
+    return false;
+}
+
+/*
+* Function: print_status
+* ----------------------------------
+* Prints a raw waitpid status the way the status built-in does.
+* 
+* Arguments: status - The status
+* 
+* Returns: void
+*/
+
+static void print_status(int status) {
+    if (WIFEXITED(status)) {
+        printf("exit value %d\n", WEXITSTATUS(status));
+    } else if (WIFSIGNALED(status)) {
+        printf("terminated by signal %d\n", WTERMSIG(status));
+    } else {
+        printf("unknown\n");
+    }
+}
+
+/*
+* Function: main
+* ----------------------------------
+* Maps a shell's status page and prints one snapshot of it.
+* 
+* Arguments: argc - The number of command line arguments
+*            argv - The command line arguments: PID, or -f FILE
+* 
+* Returns: int - EXIT_SUCCESS (0) if a snapshot was printed.
+*/
+
+int main(int argc, char *argv[]) {
+    char path[PATH_MAX];
+    if (argc == 3 && strcmp(argv[1], "-f") == 0) {
+        snprintf(path, sizeof(path), "%s", argv[2]);
+    } else if (argc == 2 && atoi(argv[1]) > 0) {
+        status_page_path(path, sizeof(path), atoi(argv[1]));
+    } else {
+        fprintf(stderr, "usage: %s PID | -f FILE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    struct status_page *page = mmap(NULL, sizeof(struct status_page), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (page == MAP_FAILED) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    if (__atomic_load_n(&page->magic, __ATOMIC_ACQUIRE) != STATUS_MAGIC
+        || page->version != STATUS_VERSION) {
+        fprintf(stderr, "%s: not a smallsh status page of version %d\n", path, STATUS_VERSION);
+        return EXIT_FAILURE;
+    }
+
+    struct status_page *snapshot = malloc(sizeof(struct status_page));
+    if (!read_snapshot(page, snapshot)) {
+        fprintf(stderr, "%s: page is busy or stale (the shell may have died mid-update)\n", path);
+        free(snapshot);
+        return EXIT_FAILURE;
+    }
+    int fg_only = __atomic_load_n(&page->foreground_only_mode, __ATOMIC_ACQUIRE);
+    time_t now = time(NULL);
+
+    printf("smallsh pid %d, snapshot %llu\n", snapshot->shell_pid,
+           (unsigned long long)snapshot->sequence / 2);
+    printf("foreground-only mode: %s\n", fg_only ? "on" : "off");
+    printf("last status: ");
+    print_status(snapshot->last_exit_status);
+    if (snapshot->foreground_pid) {
+        printf("foreground: pid %d, running %llds: %s\n", snapshot->foreground_pid,
+               (long long)(now - snapshot->foreground_start), snapshot->foreground_command);
+    } else {
+        printf("foreground: none\n");
+    }
+
+    printf("jobs: %d\n", snapshot->job_count);
+    for (int i = 0; i < snapshot->job_count && i < STATUS_MAX_JOBS; i++) {
+        struct status_job *job = &snapshot->jobs[i];
+        if (job->state == STATUS_JOB_QUEUED) {
+            printf("[%d] queued   priority %d, waiting %llds: %s\n", job->id, job->priority,
+                   (long long)(now - job->submit_time), job->command);
+        } else {
+            printf("[%d] %s pid %d, started %llds ago: %s\n", job->id,
+                   job->state == STATUS_JOB_RUNNING ? "running " : "done    ", job->pid,
+                   (long long)(now - job->start_time), job->command);
+        }
+    }
+    free(snapshot);
+    return EXIT_SUCCESS;
+}
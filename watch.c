@@ -0,0 +1,273 @@
+/*
+* Program Name: Programming Assignment 4: SMALLSH
+* Author: Allyson Villaflor
+* Email: villafla@oregonstate.edu
+* CS 374 - Operating Systems I
+* Program description: This program creates a shell called smallsh. smallsh implements a subset
+*                      if well-known shells, such as bash. The program does the following:
+*          
+*                      - Provides a prompt for running commands
+*                      - Handles blank lines and comments, which are lines beginning with the # character
+*                      - Executes 3 commands exit, cd, and status via code built into the shell
+*                      - Executes other commands by creating new processes using a function from 
+*                        the exec() family of functions
+*                      - Supports input and output redirection
+*                      - Supports running commands in foregrounf and background processes
+*                      - Implements custom handlers for 2 signals, SIGINT SIGTSTP
+*/
+
+/*
+* Citation: The following functions adapt code from Exploration: Process
+* API - Monitoring Child Processes and Exploration: Signal Handling API.
+*/
+
+#include "watch.h"
+#include "commands.h"
+#include "jobs.h"
+#include "signals.h"
+#include "status.h"
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+#define DEBOUNCE_MS 200     // Quiet period after the last change before rerunning
+
+#define WATCH_EVENTS (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE \
+                      | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_MASK_ADD)
+#define PARENT_EVENTS (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MASK_ADD)
+
+// One watched path. Editors usually save by writing a new file and
+// renaming it over the old one, which drops the inotify watch on the
+// old file. So for a file, its directory is watched too, and the
+// file's own watch is re-added whenever the name points somewhere new.
+struct watched_path {
+    const char *path;           // The path as given
+    const char *name;           // The last component, matched in parent events
+    int wd;                     // Watch on the path itself, -1 if it is gone
+    int parent_wd;              // Watch on the parent directory, -1 for directories
+};
+
+/*
+* Function: now_ms
+* ----------------------------------
+* Reads the monotonic clock.
+* 
+* Arguments: None.
+* 
+* Returns: The current time in milliseconds.
+*/
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+/*
+* Function: add_watches
+* ----------------------------------
+* Starts watching a path, and for a file also its parent directory.
+* 
+* Arguments: inotify_fd - The inotify instance
+*            w - The path to watch
+* 
+* Returns: True on success, false if the path cannot be watched.
+*/
+
+static bool add_watches(int inotify_fd, struct watched_path *w) {
+    w->wd = inotify_add_watch(inotify_fd, w->path, WATCH_EVENTS);
+    if (w->wd == -1) return false;
+
+    struct stat st;
+    w->parent_wd = -1;
+    if (stat(w->path, &st) == 0 && !S_ISDIR(st.st_mode)) {
+        const char *slash = strrchr(w->path, '/');
+        char parent[PATH_MAX];
+        if (!slash) strcpy(parent, ".");
+        else if (slash == w->path) strcpy(parent, "/");
+        else snprintf(parent, sizeof(parent), "%.*s", (int)(slash - w->path), w->path);
+        w->name = slash ? slash + 1 : w->path;
+        w->parent_wd = inotify_add_watch(inotify_fd, parent, PARENT_EVENTS);
+    }
+    return true;
+}
+
+/*
+* Function: read_events
+* ----------------------------------
+* Reads every pending inotify event, re-adding watches on files that
+* were replaced or removed.
+* 
+* Arguments: inotify_fd - The inotify instance
+*            paths - The watched paths
+*            count - The number of watched paths
+* 
+* Returns: True if any event was a change to a watched path.
+*/
+
+static bool read_events(int inotify_fd, struct watched_path *paths, int count) {
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t len;
+
+    while ((len = read(inotify_fd, events, sizeof(events))) > 0) {
+        for (char *p = events; p < events + len; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + ev->len;
+
+            for (int i = 0; i < count; i++) {
+                struct watched_path *w = &paths[i];
+                if (ev->wd == w->wd) {
+                    if (!(ev->mask & IN_IGNORED)) changed = true;
+                    if (ev->mask & IN_IGNORED) w->wd = -1;    // Deleted or replaced
+                } else if (ev->wd == w->parent_wd && ev->len && strcmp(ev->name, w->name) == 0) {
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Follow each file name to whatever it now refers to
+    for (int i = 0; i < count; i++) {
+        if (paths[i].parent_wd != -1) {
+            paths[i].wd = inotify_add_watch(inotify_fd, paths[i].path, WATCH_EVENTS);
+        }
+    }
+    return changed;
+}
+
+/*
+* Function: start_rerun
+* ----------------------------------
+* Runs the watched command once. External commands are forked without
+* waiting, so the watch can cancel them; built-ins run directly. Each
+* run gets its own process group so cancelling it also stops anything
+* it started.
+* 
+* Arguments: cmd - The command to run
+* 
+* Returns: The PID of the forked command, or 0 if it already finished.
+*/
+
+static pid_t start_rerun(struct command_line *cmd) {
+    if (builtin_commands(cmd)) return 0;
+
+    fflush(stdout);
+    pid_t spawn_pid = fork();
+    if (spawn_pid == -1) {
+        perror("fork failed");
+        exit(1);
+    } else if (spawn_pid == 0) {    // Child process
+        setpgid(0, 0);
+        run_child(cmd);
+    }
+    setpgid(spawn_pid, spawn_pid);  // Also here, so the group exists before any kill
+    status_set_foreground(spawn_pid, cmd);
+    return spawn_pid;
+}
+
+/*
+* Function: cancel_rerun
+* ----------------------------------
+* Terminates a run and every process it started. SIGCONT follows so
+* a run stopped by the terminal also receives the SIGTERM.
+* 
+* Arguments: pid - The PID of the run, which is also its process group
+* 
+* Returns: void
+*/
+
+static void cancel_rerun(pid_t pid) {
+    kill(-pid, SIGTERM);
+    kill(-pid, SIGCONT);
+}
+
+/*
+* Function: watch_command
+* ----------------------------------
+* Implements the on-change built-in: "on-change PATH... -- command".
+* Watches the paths with inotify and reruns the command once a burst
+* of changes has been quiet for DEBOUNCE_MS. A change while the command
+* is still running cancels it (SIGTERM to its process group) and
+* schedules a fresh run.
+* SIGTSTP keeps working as usual; SIGINT ends the watch.
+* 
+* Arguments: cmd - The parsed command structure
+* 
+* Returns: void
+*/
+
+void watch_command(struct command_line *cmd) {
+    int separator = 1;
+    while (separator < cmd->argc && strcmp(cmd->argv[separator], "--") != 0) separator++;
+    if (separator == 1 || separator >= cmd->argc - 1) {
+        fprintf(stderr, "usage: on-change PATH... -- command [args]\n");
+        return;
+    }
+
+    int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1) {
+        perror("on-change");
+        return;
+    }
+    int count = separator - 1;
+    struct watched_path *paths = calloc(count, sizeof(struct watched_path));
+    for (int i = 0; i < count; i++) {
+        paths[i].path = cmd->argv[i + 1];
+        if (!add_watches(inotify_fd, &paths[i])) {
+            perror(paths[i].path);
+            free(paths);
+            close(inotify_fd);
+            return;
+        }
+    }
+
+    // The command is everything after "--", with the line's redirections
+    struct command_line rerun = *cmd;
+    rerun.argc = cmd->argc - separator - 1;
+    memmove(rerun.argv, cmd->argv + separator + 1, (rerun.argc + 1) * sizeof(char *));
+    rerun.is_bg = false;
+
+    pid_t running = 0;          // PID of the current run, 0 if none
+    bool pending = false;       // A change has not been acted on yet
+    long long quiet_at = 0;     // When the current burst counts as over
+    sigint_received = 0;
+
+    while (!sigint_received) {
+        int timeout_ms = -1;
+        if (pending && !running) {
+            timeout_ms = quiet_at - now_ms();
+            if (timeout_ms < 0) timeout_ms = 0;
+        }
+
+        int child_status;
+        pid_t pid = jobs_wait(inotify_fd, timeout_ms, &child_status);
+        if (pid > 0 && pid == running) {
+            running = 0;
+            last_exit_status = child_status;    // Store exit status
+            status_set_foreground(0, NULL);
+        } else if (pid == 0 && read_events(inotify_fd, paths, count)) {
+            pending = true;
+            quiet_at = now_ms() + DEBOUNCE_MS;
+            if (running) cancel_rerun(running);     // Cancel the stale run
+        }
+
+        if (pending && !running && now_ms() >= quiet_at) {
+            pending = false;
+            running = start_rerun(&rerun);
+        }
+    }
+
+    // Stop any run still in progress before returning to the prompt
+    if (running) {
+        cancel_rerun(running);
+        int child_status;
+        while (jobs_wait(-1, -1, &child_status) != running);
+        last_exit_status = child_status;
+        status_set_foreground(0, NULL);
+    }
+    free(paths);
+    close(inotify_fd);
+}